@@ -22,6 +22,8 @@ CandidateInfo::CandidateInfo() {
 	perTreeFrequency = -1;
 	nbOccurences = -1;
 	isClosed = false;
+	canonicalForm = UNKNOWN_FORM;
+	support = UNKNOWN_SUPPORT;
 }
 
 CandidateInfo::~CandidateInfo() {
@@ -19,6 +19,8 @@
 
 #include <vector>
 #include "SequenceInfo.h"
+#include "CanonicalState.h"
+#include "TreeBitmap.h"
 
 using namespace std;
 
@@ -27,12 +29,31 @@ class CandidateInfo {
 
 public:
 	vector<SequenceInfo> subtrees;
+	// the trees of the embeddings, filled with the embeddings
+	TreeBitmap trees;
+	// result of countMotifs on the embeddings, once computed
+	int support;
+	static const int UNKNOWN_SUPPORT = -1;
 	int perTreeFrequency;
 	int nbOccurences;
 	bool isClosed;
+	// result of isCanonical on the label of the candidate
+	int canonicalForm;
+	static const int UNKNOWN_FORM = -2;
+	// state of the canonical form test, used to test the extensions
+	CanonicalState canonicalState;
 public:
 	CandidateInfo();
 	virtual ~CandidateInfo();
+
+	/**
+	 * Adds an embedding to the candidate.
+	 * @param si the embedding
+	 */
+	void addSubtree(const SequenceInfo& si) {
+		subtrees.push_back(si);
+		trees.add(si.getNbTree());
+	};
 };
 
 #endif /* CANDIDATEINFO_H_ */
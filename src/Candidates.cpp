@@ -31,96 +31,233 @@ Candidates::~Candidates() {
 
 void Candidates::addNewCandidateNode(int treeId, int label, int nodeId
 		) {
-	vector<pair<set<int>, int> > labelList;
-	set<int> labelSet;
+	ItemSet labelSet;
 	labelSet.insert(label);
-	labelList.push_back(pair<set<int>, int>(labelSet, 0));
-	vector<int> pathList;
-	pathList.push_back(nodeId);
-	vector<set<int> > labels;
-	labels.push_back(labelSet);
-	SequenceInfo si = SequenceInfo(treeId, pathList);
-	newCandidates[labelList].subtrees.push_back(si);
+	SequenceInfo si = SequenceInfo(treeId, embeddings.add(-1, nodeId), nodeId);
+	addNewCandidate(-1, pair<ItemSet, int>(labelSet, 0)).addSubtree(si);
 }
-void Candidates::addNewCandidate(vector<pair<set<int>, int> >& labelPath,
-		SequenceInfo& si) {
-	newCandidates[labelPath].subtrees.push_back(si);
+
+/**
+ * Returns the new candidate made of a stored prefix and a new last node,
+ * creating it if needed.
+ * @param parentId the id of the prefix (-1 for the empty pattern)
+ * @param node the last node of the candidate
+ */
+CandidateInfo& Candidates::addNewCandidate(int parentId,
+		const pair<ItemSet, int>& node) {
+	int patternId = patterns.intern(parentId, node);
+	pair<unordered_map<int, CandidateInfo >::iterator, bool> ret =
+			newCandidates.insert(pair<int, CandidateInfo>(patternId, CandidateInfo()));
+	if (!ret.second) {
+		patterns.release(patternId);
+	}
+	return (ret.first->second);
+}
+
+bool Candidates::compareIds::operator()(int lhs, int rhs) const {
+	if (patterns.getParent(lhs) == patterns.getParent(rhs)) {
+		return (compare::myComp(patterns.getNode(lhs), patterns.getNode(rhs)));
+	}
+	vector<pair<ItemSet, int> > l1;
+	vector<pair<ItemSet, int> > l2;
+	patterns.getLabel(lhs, l1);
+	patterns.getLabel(rhs, l2);
+	return (compare()(l1, l2));
 }
 
 void Candidates::storeNewCandidates() {
-	for (map<vector<pair<set<int>, int> >, CandidateInfo >::reverse_iterator candIt = newCandidates.rbegin();
-			candIt != newCandidates.rend();
-			){
-		pair<map<vector<pair<set<int>, int> >, CandidateInfo >::iterator, bool> ret;
+	vector<int> ids;
+	ids.reserve(newCandidates.size());
+	for (unordered_map<int, CandidateInfo >::const_iterator candIt = newCandidates.begin();
+			candIt != newCandidates.end(); candIt++) {
+		ids.push_back(candIt->first);
+	}
+	std::sort(ids.begin(), ids.end(), compareIds(patterns));
+	for (vector<int>::reverse_iterator idIt = ids.rbegin(); idIt != ids.rend(); idIt++) {
+		unordered_map<int, CandidateInfo >::iterator candIt = newCandidates.find(*idIt);
+		pair<unordered_map<int, CandidateInfo >::iterator, bool> ret;
 		ret = candidates.insert(*candIt);
-		newCandidates.erase(--(candIt.base()));
-		currentCandidates.push_back(pair<vector<pair<set<int>, int> >, CandidateInfo* >(ret.first->first, &ret.first->second));
+		if (!ret.second) {
+			patterns.release(*idIt);
+		}
+		newCandidates.erase(candIt);
+		currentCandidates.push_back(pair<int, CandidateInfo* >(ret.first->first, &ret.first->second));
 	}
 	newCandidates.clear();
 
 }
 
+/**
+ * Adds the candidates of a buffer of extensions to the new candidates.
+ * The buffer is emptied.
+ * @param parentId the id of the extended candidate
+ * @param extensions the extensions of the candidate
+ */
+void Candidates::mergeExtensions(int parentId, ExtensionBuffer& extensions) {
+	int base = embeddings.size();
+	embeddings.append(extensions.embeddings);
+	for (int i = 0; i < (int) extensions.nodes.size(); i++) {
+		vector<SequenceInfo>& subtrees = extensions.subtrees[i];
+		for (vector<SequenceInfo>::iterator si = subtrees.begin(); si != subtrees.end(); si++) {
+			*si = SequenceInfo(si->getNbTree(), base + si->getEmbedding(), si->getLast());
+		}
+		CandidateInfo& candidateInfo = addNewCandidate(parentId, extensions.nodes[i]);
+		if (extensions.canonicalStates[i].isKnown() && !candidateInfo.canonicalState.isKnown()) {
+			candidateInfo.canonicalForm = extensions.canonicalStates[i].getForm();
+			std::swap(candidateInfo.canonicalState, extensions.canonicalStates[i]);
+		}
+		vector<SequenceInfo>& target = candidateInfo.subtrees;
+		if (target.empty()) {
+			target.swap(subtrees);
+			candidateInfo.trees.swap(extensions.trees[i]);
+		} else {
+			target.insert(target.end(), subtrees.begin(), subtrees.end());
+			candidateInfo.trees.merge(extensions.trees[i]);
+		}
+	}
+	extensions.nodes.clear();
+	extensions.subtrees.clear();
+	extensions.trees.clear();
+	extensions.canonicalStates.clear();
+	extensions.embeddings.truncate(0);
+}
+
+/**
+ * Releases the embeddings created by the extension of candidates whose
+ * children have all been processed, and records a mark before the extension
+ * of the last candidate.
+ */
+void Candidates::markEmbeddings() {
+	int index = currentCandidates.size() - 1;
+	int mark = -1;
+	while (!embeddingMarks.empty() && embeddingMarks.back().first > index) {
+		mark = embeddingMarks.back().second;
+		embeddingMarks.pop_back();
+	}
+	if (mark != -1) {
+		embeddings.truncate(mark);
+	}
+	embeddingMarks.push_back(pair<int, int>(index, embeddings.size()));
+}
+
+/**
+ * Removes the first candidate of the stack (the one whose extension is the
+ * farthest away) and stores it in a task that can be processed elsewhere.
+ * @param task the detached candidate
+ */
+void Candidates::donateCandidate(MiningTask& task) {
+	pair<int, CandidateInfo* > cand = currentCandidates.front();
+	task.clear();
+	patterns.getLabel(cand.first, task.label);
+	vector<int> path;
+	for (vector<SequenceInfo>::const_iterator si = cand.second->subtrees.begin();
+			si != cand.second->subtrees.end(); si++) {
+		embeddings.getPath(si->getEmbedding(), path);
+		task.addEmbedding(si->getNbTree(), path);
+	}
+	closureIndex.remove(cand.first);
+	structuralIndex.remove(cand.first);
+	candidates.erase(cand.first);
+	patterns.release(cand.first);
+	currentCandidates.erase(currentCandidates.begin());
+	for (vector<pair<int, int> >::iterator it = embeddingMarks.begin();
+			it != embeddingMarks.end(); it++) {
+		it->first -= 1;
+	}
+}
+
+/**
+ * Pushes a candidate detached by another instance on the stack.
+ * @param task the detached candidate
+ */
+void Candidates::receiveCandidate(const MiningTask& task) {
+	if (currentCandidates.empty()) {
+		embeddingMarks.clear();
+		embeddings.truncate(0);
+	}
+	int patternId = -1;
+	for (vector<pair<ItemSet, int> >::const_iterator it = task.label.begin();
+			it != task.label.end(); it++) {
+		int childId = patterns.intern(patternId, *it);
+		if (patternId != -1) {
+			patterns.release(patternId);
+		}
+		patternId = childId;
+	}
+	pair<unordered_map<int, CandidateInfo >::iterator, bool> ret =
+			candidates.insert(pair<int, CandidateInfo>(patternId, CandidateInfo()));
+	if (!ret.second) {
+		patterns.release(patternId);
+	}
+	CandidateInfo& candidateInfo = ret.first->second;
+	for (int e = 0; e < task.size(); e++) {
+		int embedding = -1;
+		for (int n = task.pathOffsets[e]; n < task.pathOffsets[e + 1]; n++) {
+			embedding = embeddings.add(embedding, task.pathNodes[n]);
+		}
+		candidateInfo.addSubtree(SequenceInfo(task.trees[e], embedding, task.pathNodes[task.pathOffsets[e + 1] - 1]));
+	}
+	currentCandidates.push_back(pair<int, CandidateInfo* >(ret.first->first, &ret.first->second));
+}
+
 void Candidates::removeCandidate(bool keepCandidateInfo) {
-	vector<pair<vector<pair<set<int>, int> >, CandidateInfo* > >::reverse_iterator ptrCand =  currentCandidates.rbegin();
+	vector<pair<int, CandidateInfo* > >::reverse_iterator ptrCand =  currentCandidates.rbegin();
 	if (keepCandidateInfo){
 		ptrCand->second->subtrees.clear();
+		ptrCand->second->trees.clear();
+		ptrCand->second->support = CandidateInfo::UNKNOWN_SUPPORT;
+		ptrCand->second->canonicalState.clear();
 	}else{
+		closureIndex.remove(ptrCand->first);
+		structuralIndex.remove(ptrCand->first);
 		candidates.erase(ptrCand->first);
+		patterns.release(ptrCand->first);
 	}
 	currentCandidates.pop_back();
 }
-void Candidates::removeNewCandidate(const vector<pair<set<int>, int> >& labelPath) {
-	newCandidates.erase(labelPath);
+void Candidates::removeNewCandidate(int patternId) {
+	unordered_map<int, CandidateInfo >::iterator candIt = newCandidates.find(patternId);
+	if (candIt != newCandidates.end()) {
+		eraseNewCandidate(candIt);
+	}
+}
+
+void Candidates::eraseNewCandidate(unordered_map<int, CandidateInfo >::iterator candIt) {
+	patterns.release(candIt->first);
+	newCandidates.erase(candIt);
 }
 
-void Candidates::setSuperCount(CandidateInfo* candidateInfo,
+void Candidates::setSuperCount(int patternId, CandidateInfo* candidateInfo,
 		int count, int nbOcc) {
 	candidateInfo->perTreeFrequency = count;
 	candidateInfo->nbOccurences = nbOcc;
+	closureIndex.set(patterns, patternId, count, nbOcc);
+	structuralIndex.set(patterns, patternId, count, nbOcc);
 }
 
 void Candidates::setClosed(CandidateInfo* candidateInfo) {
 	candidateInfo->isClosed = true;
 }
-bool Candidates::removeUnfrequent(map<vector<set<int> >, int>& seqCount,
-		int sequencesSize, bool verbose, int absoluteSupport,
-		bool countUnique) {
-	int nbFrequent = seqCount.size();
-	bool theEnd = true;
-	/*
-	 * removing unfrequent trees
-	 */
-	for (map<vector<pair<set<int>, int> >, CandidateInfo >::iterator it =
-			candidates.begin(); it != candidates.end();) {
-		vector<SequenceInfo> values = it->second.subtrees;
-		int count = 0;
-		if (countUnique) {
-			set<int> differentTrees;
-			for (vector<SequenceInfo>::iterator sii = values.begin();
-					sii != values.end(); sii++) {
-				differentTrees.insert((*sii).getNbTree());
-			}
-			count = (int) differentTrees.size();
-		} else {
-			count = (int) values.size();
+/**
+ * Releases the embeddings of the candidates waiting for their extension
+ * whose support is lower than a raised min support. These candidates are
+ * removed when they are extended.
+ * @param support the new min support
+ * @param countUnique a flag that indicates if the support is the number of trees
+ */
+void Candidates::removeUnfrequent(int support, bool countUnique) {
+	for (vector<pair<int, CandidateInfo* > >::iterator it = currentCandidates.begin();
+			it != currentCandidates.end(); it++) {
+		CandidateInfo* candidateInfo = it->second;
+		if ((candidateInfo->support == CandidateInfo::UNKNOWN_SUPPORT) && countUnique) {
+			candidateInfo->support = candidateInfo->trees.count(0);
 		}
-		if (count >= absoluteSupport) {
-			vector<set<int> > labelPath;
-			convertLabel(it->first, labelPath);
-
-			seqCount.insert(pair<vector<set<int> >, int>(labelPath, count));
-			theEnd = false;
-			++it;
-		} else {
-			candidates.erase(it);
+		if ((candidateInfo->support != CandidateInfo::UNKNOWN_SUPPORT)
+				&& (candidateInfo->support < support)) {
+			vector<SequenceInfo>().swap(candidateInfo->subtrees);
+			candidateInfo->trees.clear();
 		}
 	}
-	if (verbose) {
-		cout << "nb of trees of size " << sequencesSize << ": "
-				<< (seqCount.size() - nbFrequent) << endl;
-	}
-
-	return (theEnd);
 }
 
 /**
@@ -128,13 +265,13 @@ bool Candidates::removeUnfrequent(map<vector<set<int> >, int>& seqCount,
  * @param lp the sequence of nodes identifiers
  * @param labelPath the output representation of nodes
  */
-void Candidates::convertLabel(const vector<pair<set<int>, int> >& lp,
-		vector<set<int> >& labelPath) const {
+void Candidates::convertLabel(const vector<pair<ItemSet, int> >& lp,
+		vector<ItemSet >& labelPath) const {
 	int depth = -1;
 	for (int i = 0; i < (int) lp.size(); i++) {
 		if (lp[i].second <= depth) {
 			for (int j = lp[i].second; j <= depth; j++) {
-				set<int> up;
+				ItemSet up;
 				up.insert(-1);
 				labelPath.push_back(up);
 			}
@@ -21,8 +21,15 @@
 #include <vector>
 #include <set>
 #include <algorithm>
+#include <unordered_map>
 #include "CandidateInfo.h"
 #include "NodeInfo.h"
+#include "PatternStore.h"
+#include "EmbeddingStore.h"
+#include "MiningTask.h"
+#include "ExtensionBuffer.h"
+#include "ItemsetClosureIndex.h"
+#include "StructuralClosureIndex.h"
 #include <iostream>
 
 using namespace std;
@@ -32,29 +39,36 @@ public:
 	Candidates();
 	virtual ~Candidates();
 	void addNewCandidateNode(int treeId, int label, int nodeId);
-	void addNewCandidate(vector<pair<set<int>, int> >& labelPath, SequenceInfo& si);
+	CandidateInfo& addNewCandidate(int parentId, const pair<ItemSet, int>& node);
 	void removeCandidate(bool keepCandidateInfo);
-	void removeNewCandidate(const vector<pair<set<int>, int> >& labelPath);
+	void removeNewCandidate(int patternId);
+	void eraseNewCandidate(unordered_map<int, CandidateInfo>::iterator it);
 	void storeNewCandidates();
-	void setSuperCount(CandidateInfo* candidateInfo,
+	void mergeExtensions(int parentId, ExtensionBuffer& extensions);
+	void markEmbeddings();
+	void donateCandidate(MiningTask& task);
+	void receiveCandidate(const MiningTask& task);
+	void setSuperCount(int patternId, CandidateInfo* candidateInfo,
 			int count, int nbOcc);
 	void setClosed(CandidateInfo* candidateInfo);
-	bool removeUnfrequent(map<vector<set<int> >, int>& seqCount,
-			int sequencesSize, bool verbose, int support, bool countUnique);
-	void convertLabel(const vector<pair<set<int>, int> >& lp,
-			vector<set<int> >& labelPath) const;
+	void removeUnfrequent(int support, bool countUnique);
+	void convertLabel(const vector<pair<ItemSet, int> >& lp,
+			vector<ItemSet >& labelPath) const;
+	void getLabel(int patternId, vector<pair<ItemSet, int> >& labelPath) const {
+		patterns.getLabel(patternId, labelPath);
+	};
 
 	const vector<SequenceInfo>* getSequencesInfo(const CandidateInfo& candidateInfo) ;
 
 
 	class compare {
 	public:
-		static bool myComp(const pair<set<int>, int>& e1,
-				const pair<set<int>, int>& e2) {
+		static bool myComp(const pair<ItemSet, int>& e1,
+				const pair<ItemSet, int>& e2) {
 			if (e1.second != e2.second)
 				return (e1.second < e2.second);
-			set<int>::const_iterator i1 = e1.first.begin();
-			set<int>::const_iterator i2 = e2.first.begin();
+			ItemSet::const_iterator i1 = e1.first.begin();
+			ItemSet::const_iterator i2 = e2.first.begin();
 			while (i1 != e1.first.end() && i2 != e2.first.end()) {
 				if (*i1 != *i2) {
 					return (*i1 < *i2);
@@ -69,17 +83,37 @@ public:
 			return (e1.first < e2.first);
 		}
 
-		bool operator()(const vector<pair<set<int>, int> >& lhs,
-				const vector<pair<set<int>, int> >& rhs) const {
+		bool operator()(const vector<pair<ItemSet, int> >& lhs,
+				const vector<pair<ItemSet, int> >& rhs) const {
 			return (lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
 					rhs.end(), myComp));
 		}
 	};
 
-	vector<pair<vector<pair<set<int>, int> >, CandidateInfo* > > currentCandidates;
+	/**
+	 * Orders pattern ids as compare orders the corresponding label paths.
+	 */
+	class compareIds {
+	public:
+		compareIds(const PatternStore& ps) : patterns(ps) {};
+		bool operator()(int lhs, int rhs) const;
+	private:
+		const PatternStore& patterns;
+	};
+
+	PatternStore patterns;
+	EmbeddingStore embeddings;
+	// (index in currentCandidates, size of embeddings) before each extension
+	vector<pair<int, int> > embeddingMarks;
+	// candidates whose support is known, for the itemset closure
+	ItemsetClosureIndex closureIndex;
+	// candidates whose support is known, for the topological closure
+	StructuralClosureIndex structuralIndex;
+
+	vector<pair<int, CandidateInfo* > > currentCandidates;
 
-	map<vector<pair<set<int>, int> >, CandidateInfo > candidates;
-	map<vector<pair<set<int>, int> >, CandidateInfo, compare > newCandidates;
+	unordered_map<int, CandidateInfo > candidates;
+	unordered_map<int, CandidateInfo > newCandidates;
 
 };
 
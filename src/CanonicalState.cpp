@@ -0,0 +1,128 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class storing the state of the canonical form test of a pattern.           |
+//----------------------------------------------------------------------------+
+
+#include "CanonicalState.h"
+
+CanonicalState::CanonicalState() {
+	size = 0;
+	known = false;
+}
+
+CanonicalState::~CanonicalState() {
+}
+
+void CanonicalState::clear() {
+	levels.clear();
+	size = 0;
+	known = false;
+}
+
+void CanonicalState::replaceReentrantNodes(const vector<pair<ItemSet, int> >& label,
+		vector<pair<ItemSet, int> >& replaced) {
+	replaced = label;
+	for (int i = 0; i < (int) replaced.size(); i++) {
+		if (*replaced[i].first.begin() < 0) {
+			int indx = -*replaced[i].first.begin() - 1;
+			replaced[i].first = replaced[indx].first;
+		}
+	}
+}
+
+void CanonicalState::build(const vector<pair<ItemSet, int> >& label) {
+	vector<pair<ItemSet, int> > replaced;
+	replaceReentrantNodes(label, replaced);
+	levels.clear();
+	size = 0;
+	known = true;
+	for (int i = 0; i < (int) replaced.size(); i++) {
+		append(replaced, replaced[i]);
+	}
+}
+
+void CanonicalState::append(const vector<pair<ItemSet, int> >& label,
+		const pair<ItemSet, int>& node) {
+	int depth = node.second;
+	if ((size == 0) || (depth == 0)) {
+		// a root has no rightmost path
+		levels.clear();
+		size += 1;
+		return;
+	}
+	// the node of the rightmost path at the same depth becomes the previous sibling
+	int sibling = -1;
+	if ((int) levels.size() >= depth) {
+		sibling = levels[depth - 1].position;
+	}
+	levels.resize(depth - 1);
+
+	// the node is appended to the part starting at each remaining node
+	for (vector<Level>::iterator level = levels.begin(); level != levels.end(); level++) {
+		if (level->status == MATCHING) {
+			if (level->matched == level->position - level->sibling) {
+				level->status = INCLUDING;
+			} else if (label[level->sibling + level->matched] == node) {
+				level->matched += 1;
+			} else {
+				level->status = DIFFERENT;
+			}
+		}
+	}
+
+	Level level;
+	level.position = size;
+	level.sibling = sibling;
+	level.matched = 0;
+	level.status = NO_SIBLING;
+	if (sibling != -1) {
+		if (label[sibling] == node) {
+			level.matched = 1;
+			level.status = MATCHING;
+		} else {
+			level.status = DIFFERENT;
+		}
+	}
+	levels.push_back(level);
+	size += 1;
+}
+
+int CanonicalState::getForm() const {
+	bool previousSibblingFound = false;
+	bool identicalRightHand = true;
+	for (vector<Level>::const_iterator level = levels.begin(); level != levels.end(); level++) {
+		switch (level->status) {
+		case NO_SIBLING:
+			break;
+		case INCLUDING:
+			return (1);
+		case DIFFERENT:
+			previousSibblingFound = true;
+			identicalRightHand = false;
+			break;
+		case MATCHING:
+			previousSibblingFound = true;
+			if (level->matched < level->position - level->sibling) {
+				identicalRightHand = false;
+			}
+			break;
+		}
+	}
+	if (identicalRightHand && previousSibblingFound) {
+		return (0);
+	}
+	return (-1);
+}
@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef CANONICALSTATE_H_
+#define CANONICALSTATE_H_
+
+#include <vector>
+#include "ItemSet.h"
+
+using namespace std;
+
+/**
+ * The state of the canonical form test of a pattern, that can be updated
+ * when a node is appended to the pattern.
+ * For each node of the rightmost path (except the root) that has a previous
+ * sibling, the state records how the subtree of the previous sibling (with
+ * the following siblings) compares with the part of the pattern starting at
+ * the node, as computed by compareSubStructure.
+ * Reentrant nodes must be replaced by the node they refer to before being
+ * given to the state.
+ */
+class CanonicalState {
+public:
+	CanonicalState();
+	virtual ~CanonicalState();
+
+	/**
+	 * Builds the state of a pattern.
+	 * @param label the sequence of nodes of the pattern
+	 */
+	void build(const vector<pair<ItemSet, int> >& label);
+
+	/**
+	 * Updates the state when a node is appended to the pattern.
+	 * @param label the sequence of nodes of the pattern before the append,
+	 *        with reentrant nodes replaced
+	 * @param node the appended node, replaced if it is a reentrant node
+	 */
+	void append(const vector<pair<ItemSet, int> >& label,
+			const pair<ItemSet, int>& node);
+
+	/**
+	 * Returns the result of isCanonical on the pattern.
+	 * @return -1 if the pattern is in canonical form ; 0 if it is in canonical
+	 * form but any extension of the rightmost path is not ; 1 if it is not in
+	 * canonical form
+	 */
+	int getForm() const;
+
+	/**
+	 * Replaces the reentrant nodes of a pattern by the node they refer to.
+	 * @param label the sequence of nodes of the pattern
+	 * @param replaced the sequence with replaced nodes
+	 */
+	static void replaceReentrantNodes(const vector<pair<ItemSet, int> >& label,
+			vector<pair<ItemSet, int> >& replaced);
+
+	/**
+	 * Returns true if the state has been built.
+	 */
+	bool isKnown() const {return (known);};
+
+	/**
+	 * Forgets the state.
+	 */
+	void clear();
+
+private:
+	enum {NO_SIBLING, MATCHING, DIFFERENT, INCLUDING};
+	struct Level {
+		// position of the node of the rightmost path
+		int position;
+		// position of its previous sibling
+		int sibling;
+		// number of nodes of the part starting at the node equal to the
+		// nodes starting at the previous sibling
+		int matched;
+		char status;
+	};
+	// nodes of the rightmost path, indexed by depth - 1
+	vector<Level> levels;
+	int size;
+	bool known;
+};
+
+#endif /* CANONICALSTATE_H_ */
@@ -0,0 +1,406 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class computing canonical certificates of patterns with bliss.             |
+//----------------------------------------------------------------------------+
+
+#include <algorithm>
+#include "CertificateIndex.h"
+#include "graph.hh"
+
+namespace {
+
+/**
+ * The order of the nodes used to find the smallest sequence of nodes.
+ */
+bool nodeLess(const pair<ItemSet, int>& a, const pair<ItemSet, int>& b) {
+	if (a.second != b.second) {
+		return (a.second > b.second);
+	}
+	return (a.first < b.first);
+}
+
+/**
+ * Computes the canonical labeling of a graph with bliss.
+ * @param graph an empty bliss graph (directed or not)
+ * @param colors the color of each vertex
+ * @param edges the edges
+ * @param labeling the position of each vertex in the canonical order
+ */
+template<class GraphType>
+void computeLabeling(GraphType& graph, const vector<unsigned int>& colors,
+		const vector<pair<int, int> >& edges, vector<unsigned int>& labeling) {
+	graph.set_splitting_heuristic(GraphType::shs_fsm);
+	for (vector<unsigned int>::const_iterator it = colors.begin(); it != colors.end(); it++) {
+		graph.add_vertex(*it);
+	}
+	for (vector<pair<int, int> >::const_iterator it = edges.begin(); it != edges.end(); it++) {
+		graph.add_edge(it->first, it->second);
+	}
+	bliss::Stats stats;
+	const unsigned int* canonicalLabeling = graph.canonical_form(stats, NULL, NULL);
+	labeling.assign(canonicalLabeling, canonicalLabeling + colors.size());
+}
+
+/**
+ * A branch and bound search of the smallest sequence of nodes describing a
+ * graph. The sequences are built as the patterns are extended: a node is
+ * added, as last child, to a node of the rightmost path, and an edge to a
+ * node already in the sequence is a reentrant node.
+ */
+class SmallestLabelSearch {
+public:
+	SmallestLabelSearch(const vector<ItemSet>& vertexLabels,
+			const vector<pair<int, int> >& edges, bool undirected) :
+				vertexLabels(vertexLabels), undirected(undirected),
+				nbEdges(edges.size()), adjacency(vertexLabels.size()),
+				usedEdges(edges.size(), 0), positions(vertexLabels.size(), -1),
+				children(vertexLabels.size()) {
+		for (int e = 0; e < (int) edges.size(); e++) {
+			adjacency[edges[e].first].push_back(pair<int, int>(edges[e].second, e));
+			if (undirected) {
+				adjacency[edges[e].second].push_back(pair<int, int>(edges[e].first, e));
+			}
+		}
+	}
+
+	void run(vector<pair<ItemSet, int> >& smallest) {
+		for (int root = 0; root < (int) vertexLabels.size(); root++) {
+			label.push_back(pair<ItemSet, int>(vertexLabels[root], 0));
+			if (!isGreaterThanBest()) {
+				positions[root] = 0;
+				path.push_back(root);
+				extend();
+				path.pop_back();
+				positions[root] = -1;
+			}
+			label.pop_back();
+		}
+		smallest = best;
+	}
+
+private:
+	struct Choice {
+		pair<ItemSet, int> node;
+		int parentDepth;
+		int vertex;
+		int edge;
+	};
+
+	static bool choiceLess(const Choice& a, const Choice& b) {
+		return (nodeLess(a.node, b.node));
+	}
+
+	/**
+	 * Tests if the current sequence is greater than the beginning of the
+	 * best one.
+	 */
+	bool isGreaterThanBest() const {
+		if (best.empty()) {
+			return (false);
+		}
+		for (uint i = 0; i < label.size(); i++) {
+			if (nodeLess(label[i], best[i])) {
+				return (false);
+			}
+			if (nodeLess(best[i], label[i])) {
+				return (true);
+			}
+		}
+		return (false);
+	}
+
+	/**
+	 * Tests if a node leaving the rightmost path has an edge that can no
+	 * longer be added.
+	 * @param vertex the node leaving the rightmost path
+	 * @param kept the number of nodes remaining on the rightmost path
+	 * @param addedEdge the edge being added
+	 */
+	bool hasPendingEdge(int vertex, int kept, int addedEdge) const {
+		for (vector<pair<int, int> >::const_iterator it = adjacency[vertex].begin();
+				it != adjacency[vertex].end(); it++) {
+			if ((it->second == addedEdge) || usedEdges[it->second]) {
+				continue;
+			}
+			if (!undirected) {
+				return (true);
+			}
+			// the other node can still add the edge if it is not yet in
+			// the sequence or if it stays on the rightmost path
+			if ((positions[it->first] != -1)
+					&& (std::find(path.begin(), path.begin() + kept, it->first) == path.begin() + kept)) {
+				return (true);
+			}
+		}
+		return (false);
+	}
+
+	/**
+	 * Tests if an edge can be added to a node of the rightmost path. As in
+	 * the extension of the patterns, a node has at most one child for each
+	 * of its neighbours, and, in an undirected graph, the last node has no
+	 * edge back to its parent.
+	 * @param d the depth of the node on the rightmost path
+	 * @param vertex the other end of the edge
+	 */
+	bool isAllowed(int d, int vertex) const {
+		if (positions[vertex] == -1) {
+			return (true);
+		}
+		if (std::find(children[path[d]].begin(), children[path[d]].end(), vertex)
+				!= children[path[d]].end()) {
+			return (false);
+		}
+		return (!(undirected && (d > 0) && (vertex == path[d - 1])
+				&& (positions[path[d]] == (int) label.size() - 1)));
+	}
+
+	void extend() {
+		if ((int) label.size() == nbEdges + 1) {
+			if (best.empty() || !isGreaterThanBest()) {
+				best = label;
+			}
+			return;
+		}
+		vector<Choice> choices;
+		for (int d = 0; d < (int) path.size(); d++) {
+			for (vector<pair<int, int> >::const_iterator it = adjacency[path[d]].begin();
+					it != adjacency[path[d]].end(); it++) {
+				if (usedEdges[it->second] || !isAllowed(d, it->first)) {
+					continue;
+				}
+				Choice c;
+				if (positions[it->first] == -1) {
+					c.node.first = vertexLabels[it->first];
+				} else {
+					c.node.first.insert(-(positions[it->first] + 1));
+					c.node.first.insert(999);
+				}
+				c.node.second = d + 1;
+				c.parentDepth = d;
+				c.vertex = it->first;
+				c.edge = it->second;
+				choices.push_back(c);
+			}
+		}
+		std::stable_sort(choices.begin(), choices.end(), choiceLess);
+		for (vector<Choice>::const_iterator c = choices.begin(); c != choices.end(); c++) {
+			label.push_back(c->node);
+			if (isGreaterThanBest()) {
+				// the next choices are not smaller
+				label.pop_back();
+				break;
+			}
+			bool blocked = false;
+			for (int d = c->parentDepth + 1; d < (int) path.size() && !blocked; d++) {
+				blocked = hasPendingEdge(path[d], c->parentDepth + 1, c->edge);
+			}
+			if (!blocked) {
+				vector<int> previousPath = path;
+				usedEdges[c->edge] = 1;
+				path.resize(c->parentDepth + 1);
+				children[path.back()].push_back(c->vertex);
+				bool newVertex = (positions[c->vertex] == -1);
+				if (newVertex) {
+					positions[c->vertex] = label.size() - 1;
+					path.push_back(c->vertex);
+				}
+				extend();
+				if (newVertex) {
+					positions[c->vertex] = -1;
+				}
+				usedEdges[c->edge] = 0;
+				path = previousPath;
+				children[path[c->parentDepth]].pop_back();
+			}
+			label.pop_back();
+		}
+	}
+
+	const vector<ItemSet>& vertexLabels;
+	bool undirected;
+	int nbEdges;
+	// the neighbours of each node, with the index of the edge
+	vector<vector<pair<int, int> > > adjacency;
+	vector<char> usedEdges;
+	// the position of each node in the current sequence, -1 if absent
+	vector<int> positions;
+	// the nodes of the children of each node in the current sequence
+	vector<vector<int> > children;
+	// the nodes of the rightmost path
+	vector<int> path;
+	vector<pair<ItemSet, int> > label;
+	vector<pair<ItemSet, int> > best;
+};
+
+}
+
+CertificateIndex::CertificateIndex() {
+}
+
+CertificateIndex::~CertificateIndex() {
+}
+
+bool CertificateIndex::containsReentrantNode(const vector<pair<ItemSet, int> >& label) {
+	for (vector<pair<ItemSet, int> >::const_iterator node = label.begin();
+			node != label.end(); node++) {
+		if (*node->first.begin() < 0) {
+			return (true);
+		}
+	}
+	return (false);
+}
+
+void CertificateIndex::encode(const vector<pair<ItemSet, int> >& label,
+		vector<int>& code) {
+	code.clear();
+	for (vector<pair<ItemSet, int> >::const_iterator node = label.begin();
+			node != label.end(); node++) {
+		code.push_back(node->second);
+		code.push_back(node->first.size());
+		code.insert(code.end(), node->first.begin(), node->first.end());
+	}
+}
+
+void CertificateIndex::buildGraph(const vector<pair<ItemSet, int> >& label,
+		vector<ItemSet>& vertexLabels, vector<pair<int, int> >& edges) {
+	vertexLabels.clear();
+	edges.clear();
+	vector<int> vertexOfNode(label.size());
+	vector<int> path;
+	for (uint i = 0; i < label.size(); i++) {
+		int code = *label[i].first.begin();
+		if (code < 0) {
+			// an edge to the node the reentrant node refers to
+			vertexOfNode[i] = vertexOfNode[-code - 1];
+		} else {
+			vertexOfNode[i] = vertexLabels.size();
+			vertexLabels.push_back(label[i].first);
+		}
+		path.resize(label[i].second);
+		if (!path.empty()) {
+			edges.push_back(pair<int, int>(path.back(), vertexOfNode[i]));
+		}
+		path.push_back(vertexOfNode[i]);
+	}
+}
+
+void CertificateIndex::computeCertificate(const vector<pair<ItemSet, int> >& label,
+		bool undirected, vector<int>& certificate) {
+	vector<ItemSet> vertexLabels;
+	vector<pair<int, int> > edges;
+	buildGraph(label, vertexLabels, edges);
+
+	// the colors of the vertices are the ranks of their labels
+	vector<ItemSet> colors = vertexLabels;
+	std::sort(colors.begin(), colors.end());
+	colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+	vector<unsigned int> vertexColors;
+	for (vector<ItemSet>::const_iterator it = vertexLabels.begin(); it != vertexLabels.end(); it++) {
+		vertexColors.push_back(std::lower_bound(colors.begin(), colors.end(), *it) - colors.begin());
+	}
+
+	vector<unsigned int> labeling;
+	if (undirected) {
+		bliss::Graph g(0);
+		computeLabeling(g, vertexColors, edges, labeling);
+	} else {
+		bliss::Digraph g(0);
+		computeLabeling(g, vertexColors, edges, labeling);
+	}
+
+	certificate.clear();
+	certificate.push_back(vertexColors.size());
+	certificate.push_back(edges.size());
+	certificate.push_back(colors.size());
+	for (vector<ItemSet>::const_iterator it = colors.begin(); it != colors.end(); it++) {
+		certificate.push_back(it->size());
+		certificate.insert(certificate.end(), it->begin(), it->end());
+	}
+	vector<int> orderedColors(vertexColors.size());
+	for (uint v = 0; v < vertexColors.size(); v++) {
+		orderedColors[labeling[v]] = vertexColors[v];
+	}
+	certificate.insert(certificate.end(), orderedColors.begin(), orderedColors.end());
+	for (vector<pair<int, int> >::iterator it = edges.begin(); it != edges.end(); it++) {
+		it->first = labeling[it->first];
+		it->second = labeling[it->second];
+		if (undirected && (it->first > it->second)) {
+			std::swap(it->first, it->second);
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+	for (vector<pair<int, int> >::const_iterator it = edges.begin(); it != edges.end(); it++) {
+		certificate.push_back(it->first);
+		certificate.push_back(it->second);
+	}
+}
+
+void CertificateIndex::computeSmallestLabel(const vector<pair<ItemSet, int> >& label,
+		bool undirected, vector<pair<ItemSet, int> >& smallest) {
+	vector<ItemSet> vertexLabels;
+	vector<pair<int, int> > edges;
+	buildGraph(label, vertexLabels, edges);
+	SmallestLabelSearch search(vertexLabels, edges, undirected);
+	search.run(smallest);
+}
+
+bool CertificateIndex::isCanonical(const vector<pair<ItemSet, int> >& label,
+		bool undirected) {
+	vector<int> code;
+	encode(label, code);
+	vector<int> certificate;
+	{
+		lock_guard<mutex> lock(indexMutex);
+		unordered_map<vector<int>, bool, IntSequenceHash>::const_iterator known =
+				verdicts.find(code);
+		if (known != verdicts.end()) {
+			return (known->second);
+		}
+	}
+	// bliss and the search work on their own data, they run unlocked
+	computeCertificate(label, undirected, certificate);
+	vector<int> smallestCode;
+	bool knownCertificate = false;
+	{
+		lock_guard<mutex> lock(indexMutex);
+		unordered_map<vector<int>, vector<int>, IntSequenceHash>::const_iterator known =
+				smallestCodes.find(certificate);
+		if (known != smallestCodes.end()) {
+			smallestCode = known->second;
+			knownCertificate = true;
+		}
+	}
+	if (!knownCertificate) {
+		vector<pair<ItemSet, int> > smallest;
+		computeSmallestLabel(label, undirected, smallest);
+		encode(smallest, smallestCode);
+	}
+	bool canonical = (smallestCode == code);
+	lock_guard<mutex> lock(indexMutex);
+	// the caches only hold results that can be computed again
+	if (verdicts.size() >= maxCacheSize) {
+		verdicts.clear();
+	}
+	if (smallestCodes.size() >= maxCacheSize) {
+		smallestCodes.clear();
+	}
+	verdicts[code] = canonical;
+	if (!knownCertificate) {
+		smallestCodes[certificate] = smallestCode;
+	}
+	return (canonical);
+}
@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef CERTIFICATEINDEX_H_
+#define CERTIFICATEINDEX_H_
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include "ItemSet.h"
+#include "common.h"
+
+using namespace std;
+
+/**
+ * An index of the canonical forms of the patterns containing reentrant
+ * nodes. The graph of such a pattern (a reentrant node adds an edge to the
+ * node it refers to) can be described by several sequences of nodes; its
+ * canonical form is the smallest of them, nodes being compared by
+ * decreasing depth, then by label. The search for the smallest sequence is
+ * done once per graph: its result is stored under the certificate that
+ * bliss computes for the graph, which is the same for all the sequences
+ * describing it. The index can be shared by several threads.
+ */
+class CertificateIndex {
+public:
+	CertificateIndex();
+	virtual ~CertificateIndex();
+
+	/**
+	 * Tests if a pattern is the canonical form of its graph. The result is
+	 * cached per pattern.
+	 * @param label the sequence of nodes of a pattern
+	 * @param undirected true if the edges of the pattern are undirected
+	 * @return true if the pattern is the smallest sequence of nodes
+	 * describing its graph
+	 */
+	bool isCanonical(const vector<pair<ItemSet, int> >& label, bool undirected);
+
+	/**
+	 * Computes the canonical certificate of a pattern.
+	 * @param label the sequence of nodes of a pattern
+	 * @param undirected true if the edges of the pattern are undirected
+	 * @param certificate the resulting certificate
+	 */
+	static void computeCertificate(const vector<pair<ItemSet, int> >& label,
+			bool undirected, vector<int>& certificate);
+
+	/**
+	 * Computes the smallest sequence of nodes describing the graph of a
+	 * pattern.
+	 * @param label the sequence of nodes of a pattern
+	 * @param undirected true if the edges of the pattern are undirected
+	 * @param smallest the resulting sequence of nodes
+	 */
+	static void computeSmallestLabel(const vector<pair<ItemSet, int> >& label,
+			bool undirected, vector<pair<ItemSet, int> >& smallest);
+
+	/**
+	 * Tests if a pattern contains reentrant nodes.
+	 * @param label the sequence of nodes of a pattern
+	 */
+	static bool containsReentrantNode(const vector<pair<ItemSet, int> >& label);
+
+	/**
+	 * the number of entries of a cache above which it is emptied
+	 */
+	static const size_t maxCacheSize = 1 << 16;
+
+private:
+	static void encode(const vector<pair<ItemSet, int> >& label,
+			vector<int>& code);
+	static void buildGraph(const vector<pair<ItemSet, int> >& label,
+			vector<ItemSet>& vertexLabels, vector<pair<int, int> >& edges);
+	// the verdict of each tested pattern
+	unordered_map<vector<int>, bool, IntSequenceHash> verdicts;
+	// the code of the smallest sequence of nodes of each certificate
+	unordered_map<vector<int>, vector<int>, IntSequenceHash> smallestCodes;
+	mutex indexMutex;
+};
+
+#endif /* CERTIFICATEINDEX_H_ */
@@ -0,0 +1,91 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class storing the graphs of a dataset in compressed sparse row form.       |
+//----------------------------------------------------------------------------+
+
+#include "Dataset.h"
+
+Dataset::Dataset() {
+	graphOffsets.push_back(0);
+	childOffsets.push_back(0);
+	labelOffsets.push_back(0);
+}
+
+Dataset::~Dataset() {
+}
+
+void Dataset::addGraph(const vector<NodeInfo>& nodes) {
+	for (vector<NodeInfo>::const_iterator ni = nodes.begin(); ni != nodes.end();
+			ni++) {
+		children.insert(children.end(), ni->childNodes.begin(), ni->childNodes.end());
+		childOffsets.push_back(children.size());
+		labels.insert(labels.end(), ni->labels.begin(), ni->labels.end());
+		labelOffsets.push_back(labels.size());
+		depths.push_back(ni->depth);
+	}
+	graphOffsets.push_back(depths.size());
+}
+
+void Dataset::addGraphs(const Dataset& other) {
+	int nodeShift = depths.size();
+	int childShift = children.size();
+	int labelShift = labels.size();
+	for (int g = 1; g < (int) other.graphOffsets.size(); g++) {
+		graphOffsets.push_back(other.graphOffsets[g] + nodeShift);
+	}
+	for (int n = 1; n < (int) other.childOffsets.size(); n++) {
+		childOffsets.push_back(other.childOffsets[n] + childShift);
+		labelOffsets.push_back(other.labelOffsets[n] + labelShift);
+	}
+	children.insert(children.end(), other.children.begin(), other.children.end());
+	labels.insert(labels.end(), other.labels.begin(), other.labels.end());
+	depths.insert(depths.end(), other.depths.begin(), other.depths.end());
+}
+
+void Dataset::filterLabels(const set<int>& kept) {
+	int nbLabels = 0;
+	int first = 0;
+	for (int n = 0; n < (int) depths.size(); n++) {
+		int last = labelOffsets[n + 1];
+		for (int l = first; l < last; l++) {
+			if (kept.count(labels[l]) != 0) {
+				labels[nbLabels] = labels[l];
+				nbLabels += 1;
+			}
+		}
+		first = last;
+		labelOffsets[n + 1] = nbLabels;
+	}
+	labels.resize(nbLabels);
+}
+
+void Dataset::remapLabels(vector<int>& dictionary) {
+	dictionary = labels;
+	std::sort(dictionary.begin(), dictionary.end());
+	dictionary.erase(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+	for (vector<int>::iterator l = labels.begin(); l != labels.end(); l++) {
+		*l = std::lower_bound(dictionary.begin(), dictionary.end(), *l) - dictionary.begin();
+	}
+}
+
+void Dataset::swap(Dataset& other) {
+	graphOffsets.swap(other.graphOffsets);
+	childOffsets.swap(other.childOffsets);
+	children.swap(other.children);
+	labelOffsets.swap(other.labelOffsets);
+	labels.swap(other.labels);
+	depths.swap(other.depths);
+}
@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef DATASET_H_
+#define DATASET_H_
+
+#include <vector>
+#include <set>
+#include <algorithm>
+#include "NodeInfo.h"
+
+using namespace std;
+
+/**
+ * The graphs of a dataset in compressed sparse row form.
+ * Nodes of all graphs are numbered consecutively. For each node, the
+ * identifiers of its child nodes (local to its graph, sorted) and its labels
+ * (sorted) are stored in two contiguous arrays indexed by offset arrays.
+ */
+class Dataset {
+public:
+	/**
+	 * A read only sequence of sorted integers stored in the dataset.
+	 */
+	class Range {
+	public:
+		typedef const int* const_iterator;
+		Range(const int* first, const int* last) : first(first), last(last) {};
+		const_iterator begin() const {return (first);};
+		const_iterator end() const {return (last);};
+		int size() const {return (last - first);};
+		bool empty() const {return (first == last);};
+		int count(int value) const {return (std::binary_search(first, last, value) ? 1 : 0);};
+	private:
+		const int* first;
+		const int* last;
+	};
+
+	/**
+	 * A view on a node of the dataset.
+	 */
+	class Node {
+	public:
+		Node(const Dataset& ds, int index) :
+			labels(ds.labels.data() + ds.labelOffsets[index], ds.labels.data() + ds.labelOffsets[index + 1]),
+			childNodes(ds.children.data() + ds.childOffsets[index], ds.children.data() + ds.childOffsets[index + 1]),
+			depth(ds.depths[index]) {};
+		/**
+		 * A flag that indicates if the node is frequent
+		 * @return true if the node is frequent
+		 */
+		bool isFrequent() const {return (!labels.empty());};
+		Range labels;
+		Range childNodes;
+		int depth;
+	};
+
+	/**
+	 * A view on a graph of the dataset.
+	 */
+	class Graph {
+	public:
+		Graph(const Dataset& ds, int graphId) :
+			dataset(&ds), firstNode(ds.graphOffsets[graphId]),
+			nbNodes(ds.graphOffsets[graphId + 1] - ds.graphOffsets[graphId]) {};
+		Node operator[](int n) const {return (Node(*dataset, firstNode + n));};
+		int size() const {return (nbNodes);};
+	private:
+		const Dataset* dataset;
+		int firstNode;
+		int nbNodes;
+	};
+
+	Dataset();
+	virtual ~Dataset();
+
+	/**
+	 * Returns a view on a graph
+	 */
+	Graph operator[](int graphId) const {return (Graph(*this, graphId));};
+
+	/**
+	 * Returns the number of graphs
+	 */
+	int size() const {return (graphOffsets.size() - 1);};
+
+	/**
+	 * Returns the number of nodes in all graphs
+	 */
+	int getNbNodes() const {return (depths.size());};
+
+	/**
+	 * Appends a graph given as a sequence of nodes.
+	 * @param nodes the nodes of the graph
+	 */
+	void addGraph(const vector<NodeInfo>& nodes);
+
+	/**
+	 * Appends all the graphs of another dataset.
+	 * @param other a dataset
+	 */
+	void addGraphs(const Dataset& other);
+
+	/**
+	 * Removes, from all nodes, the labels that are not in a given set.
+	 * @param kept the labels to keep
+	 */
+	void filterLabels(const set<int>& kept);
+
+	/**
+	 * Replaces the labels by their rank in the sorted list of distinct labels.
+	 * The mapping is monotone, so the labels of a node stay sorted.
+	 * @param dictionary the original labels, indexed by their new value
+	 */
+	void remapLabels(vector<int>& dictionary);
+
+	/**
+	 * Exchanges the content of two datasets.
+	 */
+	void swap(Dataset& other);
+
+private:
+	// first node of each graph (one extra element at the end)
+	vector<int> graphOffsets;
+	// first child of each node in children (one extra element at the end)
+	vector<int> childOffsets;
+	vector<int> children;
+	// first label of each node in labels (one extra element at the end)
+	vector<int> labelOffsets;
+	vector<int> labels;
+	vector<int> depths;
+};
+
+#endif /* DATASET_H_ */
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef EMBEDDINGSTORE_H_
+#define EMBEDDINGSTORE_H_
+
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * A tree of embeddings.
+ * An embedding of a pattern is stored as the embedding of the pattern
+ * without its last node (its parent) and the id of the node matched by the
+ * last node. Embeddings are allocated in a stack like arena: the embeddings
+ * created after a mark can be released at once with truncate().
+ */
+class EmbeddingStore {
+public:
+	EmbeddingStore();
+	virtual ~EmbeddingStore();
+
+	/**
+	 * Adds an embedding.
+	 * @param parent the index of the parent embedding (-1 for none)
+	 * @param node the id of the node appended to the parent embedding
+	 * @return the index of the new embedding
+	 */
+	int add(int parent, int node) {
+		records.push_back(Record(parent, node));
+		return (records.size() - 1);
+	};
+
+	/**
+	 * Returns the index of the parent embedding
+	 */
+	int getParent(int embedding) const {return (records[embedding].parent);};
+
+	/**
+	 * Returns the id of the last node of the embedding
+	 */
+	int getNode(int embedding) const {return (records[embedding].node);};
+
+	/**
+	 * Rebuilds the ids of the nodes of an embedding, from the first to the last.
+	 * @param embedding the index of the embedding
+	 * @param path the ids of the nodes
+	 */
+	void getPath(int embedding, vector<int>& path) const {
+		path.clear();
+		while (embedding != -1) {
+			path.push_back(records[embedding].node);
+			embedding = records[embedding].parent;
+		}
+		std::reverse(path.begin(), path.end());
+	};
+
+	/**
+	 * Appends the embeddings of another store, whose parents are stored in
+	 * this one. The index of an appended embedding is increased by the size
+	 * of this store before the call.
+	 * @param other a store of embeddings
+	 */
+	void append(const EmbeddingStore& other) {
+		records.insert(records.end(), other.records.begin(), other.records.end());
+	};
+
+	/**
+	 * Returns the number of stored embeddings, to be used as a mark
+	 */
+	int size() const {return (records.size());};
+
+	/**
+	 * Releases all the embeddings created after a mark.
+	 * @param mark a value returned by size()
+	 */
+	void truncate(int mark) {records.erase(records.begin() + mark, records.end());};
+
+private:
+	struct Record {
+		Record(int parent, int node) : parent(parent), node(node) {};
+		int parent;
+		int node;
+	};
+	vector<Record> records;
+};
+
+#endif /* EMBEDDINGSTORE_H_ */
@@ -0,0 +1,34 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class storing the extensions of a candidate before their merge.            |
+//----------------------------------------------------------------------------+
+
+#include "ExtensionBuffer.h"
+
+ExtensionBuffer::ExtensionBuffer() {
+}
+
+ExtensionBuffer::~ExtensionBuffer() {
+}
+
+int ExtensionBuffer::addCandidate(const pair<ItemSet, int>& node,
+		const CanonicalState& canonicalState) {
+	nodes.push_back(node);
+	canonicalStates.push_back(canonicalState);
+	subtrees.push_back(vector<SequenceInfo>());
+	trees.push_back(TreeBitmap());
+	return ((int) nodes.size() - 1);
+}
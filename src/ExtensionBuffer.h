@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef EXTENSIONBUFFER_H_
+#define EXTENSIONBUFFER_H_
+
+#include <deque>
+#include <vector>
+#include "ItemSet.h"
+#include "SequenceInfo.h"
+#include "EmbeddingStore.h"
+#include "CandidateInfo.h"
+#include "TreeBitmap.h"
+
+using namespace std;
+
+/**
+ * The extensions of a candidate generated from a range of its embeddings.
+ * New embeddings are stored in a private store ; their parents are
+ * embeddings of the store of the candidate. A buffer can be filled without
+ * modifying the candidates, and merged later with Candidates::mergeExtensions.
+ */
+class ExtensionBuffer {
+public:
+	ExtensionBuffer();
+	virtual ~ExtensionBuffer();
+
+	/**
+	 * Adds a new candidate made of the extended candidate and a new last node.
+	 * @param node the last node of the new candidate
+	 * @param canonicalState the state of the canonical form test of the new candidate, if known
+	 * @return the index of the new candidate
+	 */
+	int addCandidate(const pair<ItemSet, int>& node,
+			const CanonicalState& canonicalState = CanonicalState());
+
+	/**
+	 * Adds an embedding to a new candidate.
+	 * @param candidate the index of the new candidate
+	 * @param si the embedding
+	 */
+	void addSubtree(int candidate, const SequenceInfo& si) {
+		subtrees[candidate].push_back(si);
+		trees[candidate].add(si.getNbTree());
+	};
+
+	// the last node of each new candidate
+	deque<pair<ItemSet, int> > nodes;
+	// the embeddings of each new candidate
+	deque<vector<SequenceInfo> > subtrees;
+	// the trees of the embeddings of each new candidate
+	deque<TreeBitmap> trees;
+	deque<CanonicalState> canonicalStates;
+	EmbeddingStore embeddings;
+};
+
+#endif /* EXTENSIONBUFFER_H_ */
@@ -0,0 +1,229 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class storing the patterns of the previous searches on a dataset.          |
+//----------------------------------------------------------------------------+
+
+#include <fstream>
+#include <algorithm>
+#include "IncrementalState.h"
+
+// the first line of the files, with the version of the format
+static const string STATE_HEADER = "aadage-state 2";
+
+IncrementalState::Entry::Entry() {
+	unknownTrees = 0;
+	recordedFrom = 0;
+	rank = -1;
+}
+
+int IncrementalState::Entry::getMaxSupport(int firstTree) const {
+	int support = trees.count(firstTree);
+	if (firstTree < recordedFrom) {
+		support += min(unknownTrees, recordedFrom - firstTree);
+	}
+	return (support);
+}
+
+IncrementalState::IncrementalState() {
+	nbTrees = 0;
+	firstTree = 0;
+	nbExtended = 0;
+}
+
+IncrementalState::~IncrementalState() {
+}
+
+const IncrementalState::Entry* IncrementalState::find(const string& pattern) const {
+	unordered_map<string, Entry>::const_iterator it = patterns.find(pattern);
+	if (it == patterns.end()) {
+		return (NULL);
+	}
+	return (&it->second);
+}
+
+void IncrementalState::setExtended(const string& pattern) {
+	Entry& entry = patterns[pattern];
+	if (entry.rank == -1) {
+		entry.rank = nbExtended++;
+	}
+}
+
+bool IncrementalState::isExtended(const string& pattern) const {
+	const Entry* entry = find(pattern);
+	return ((entry != NULL) && (entry->rank != -1));
+}
+
+void IncrementalState::getExtended(vector<pair<const string*, const Entry*> >& ranked) const {
+	ranked.assign(nbExtended, pair<const string*, const Entry*>(NULL, NULL));
+	for (unordered_map<string, Entry>::const_iterator it = patterns.begin();
+			it != patterns.end(); it++) {
+		if (it->second.rank != -1) {
+			ranked[it->second.rank] = pair<const string*, const Entry*>(&it->first, &it->second);
+		}
+	}
+}
+
+bool IncrementalState::isRecorded(int label) const {
+	map<int, int>::const_iterator it = labelTrees.find(label);
+	return ((it != labelTrees.end()) && (getUnknownTrees(label) < it->second));
+}
+
+int IncrementalState::getUnknownTrees(int label) const {
+	map<int, int>::const_iterator it = unknownLabelTrees.find(label);
+	return (it == unknownLabelTrees.end() ? 0 : it->second);
+}
+
+bool IncrementalState::canBecomeFrequent(const IncrementalState& appended, int support) const {
+	for (unordered_map<string, Entry>::const_iterator it = appended.patterns.begin();
+			it != appended.patterns.end(); it++) {
+		const Entry* entry = find(it->first);
+		if ((entry != NULL) && (entry->rank != -1)) {
+			continue;
+		}
+		// the unknown trees of the appended patterns are trees of this state
+		int maxSupport = it->second.trees.count(0);
+		if (entry != NULL) {
+			maxSupport += entry->getMaxSupport(firstTree);
+		} else {
+			maxSupport += min(it->second.unknownTrees, nbTrees - firstTree);
+		}
+		if (maxSupport >= support) {
+			return (true);
+		}
+	}
+	return (false);
+}
+
+void IncrementalState::append(const IncrementalState& appended) {
+	for (unordered_map<string, Entry>::const_iterator it = appended.patterns.begin();
+			it != appended.patterns.end(); it++) {
+		pair<unordered_map<string, Entry>::iterator, bool> ret =
+				patterns.insert(pair<string, Entry>(it->first, Entry()));
+		if (ret.second) {
+			// the pattern was not recorded, its support is only bounded
+			ret.first->second.unknownTrees = it->second.unknownTrees;
+			ret.first->second.recordedFrom = nbTrees;
+		}
+		ret.first->second.trees.merge(it->second.trees, nbTrees);
+	}
+	for (map<int, int>::const_iterator it = appended.labelTrees.begin();
+			it != appended.labelTrees.end(); it++) {
+		labelTrees[it->first] += it->second;
+	}
+	for (map<int, int>::const_iterator it = appended.unknownLabelTrees.begin();
+			it != appended.unknownLabelTrees.end(); it++) {
+		unknownLabelTrees[it->first] += it->second;
+	}
+	nbTrees += appended.nbTrees;
+}
+
+void IncrementalState::removeTrees(int nbRemoved, const map<int, int>& removedLabels) {
+	firstTree += nbRemoved;
+	for (map<int, int>::const_iterator it = removedLabels.begin();
+			it != removedLabels.end(); it++) {
+		map<int, int>::iterator labelIt = labelTrees.find(it->first);
+		labelIt->second -= it->second;
+		if (labelIt->second == 0) {
+			labelTrees.erase(labelIt);
+		}
+		// the trees in which the label is not recorded are the first ones
+		labelIt = unknownLabelTrees.find(it->first);
+		if (labelIt != unknownLabelTrees.end()) {
+			labelIt->second -= it->second;
+			if (labelIt->second <= 0) {
+				unknownLabelTrees.erase(labelIt);
+			}
+		}
+	}
+}
+
+void IncrementalState::forgetRemovedTrees() {
+	for (unordered_map<string, Entry>::iterator it = patterns.begin(); it != patterns.end();) {
+		if ((it->second.rank == -1) && (it->second.getMaxSupport(firstTree) == 0)) {
+			it = patterns.erase(it);
+		} else {
+			it->second.trees.removeBefore(firstTree);
+			it++;
+		}
+	}
+}
+
+void IncrementalState::clear() {
+	signature.clear();
+	nbTrees = 0;
+	firstTree = 0;
+	labelTrees.clear();
+	unknownLabelTrees.clear();
+	patterns.clear();
+	nbExtended = 0;
+}
+
+bool IncrementalState::read(const string& fileName) {
+	clear();
+	ifstream in(fileName.c_str());
+	string line;
+	if (!getline(in, line) || (line != STATE_HEADER) || !getline(in, signature)) {
+		return (false);
+	}
+	string key;
+	int nbLabels = 0;
+	in >> key >> nbTrees >> firstTree >> key >> nbLabels;
+	for (int i = 0; (i < nbLabels) && in; i++) {
+		int label = 0;
+		int unknown = 0;
+		in >> label;
+		in >> labelTrees[label] >> unknown;
+		if (unknown != 0) {
+			unknownLabelTrees[label] = unknown;
+		}
+	}
+	int nbPatterns = 0;
+	in >> key >> nbPatterns;
+	for (int i = 0; (i < nbPatterns) && in; i++) {
+		Entry entry;
+		in >> entry.rank >> entry.unknownTrees >> entry.recordedFrom;
+		if (!entry.trees.read(in) || (in.get() != '\t') || !getline(in, line)) {
+			break;
+		}
+		nbExtended = max(nbExtended, entry.rank + 1);
+		patterns[line] = entry;
+	}
+	if (!in || ((int) patterns.size() != nbPatterns)) {
+		clear();
+		return (false);
+	}
+	return (true);
+}
+
+bool IncrementalState::write(const string& fileName) const {
+	ofstream out(fileName.c_str());
+	out << STATE_HEADER << endl << signature << endl;
+	out << "trees " << nbTrees << " " << firstTree << endl;
+	out << "labels " << labelTrees.size() << endl;
+	for (map<int, int>::const_iterator it = labelTrees.begin();
+			it != labelTrees.end(); it++) {
+		out << it->first << " " << it->second << " " << getUnknownTrees(it->first) << endl;
+	}
+	out << "patterns " << patterns.size() << endl;
+	for (unordered_map<string, Entry>::const_iterator it = patterns.begin();
+			it != patterns.end(); it++) {
+		out << it->second.rank << " " << it->second.unknownTrees << " "
+				<< it->second.recordedFrom << " ";
+		it->second.trees.write(out);
+		out << "\t" << it->first << endl;
+	}
+	return (!out.fail());
+}
@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef INCREMENTALSTATE_H_
+#define INCREMENTALSTATE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "TreeBitmap.h"
+
+using namespace std;
+
+/**
+ * The patterns found by the previous searches on a dataset, so that trees
+ * appended to the dataset can be mined without searching the whole dataset
+ * again.
+ * Patterns are identified by their output text (with the labels of the
+ * dataset). The extended patterns are the frequent ones, in the order they
+ * were written ; the other patterns are their extensions (the border).
+ */
+class IncrementalState {
+public:
+	/**
+	 * A pattern recorded by a search.
+	 */
+	class Entry {
+	public:
+		Entry();
+
+		/**
+		 * Returns an upper bound of the support of the pattern.
+		 * @param firstTree the trees with a lower index are not counted
+		 */
+		int getMaxSupport(int firstTree) const;
+
+		// the trees known to contain the pattern
+		TreeBitmap trees;
+		// an upper bound of the number of the trees before recordedFrom
+		// containing the pattern
+		int unknownTrees;
+		// the index of the first tree from which the pattern is recorded
+		int recordedFrom;
+		// the rank of the pattern in the output, -1 if it was not extended
+		int rank;
+	};
+
+	IncrementalState();
+	virtual ~IncrementalState();
+
+	/**
+	 * Returns the entry of a pattern, created if it is unknown.
+	 * @param pattern the text of the pattern
+	 */
+	Entry& get(const string& pattern) {return (patterns[pattern]);};
+
+	/**
+	 * Returns the entry of a pattern, or NULL if it is unknown.
+	 * @param pattern the text of the pattern
+	 */
+	const Entry* find(const string& pattern) const;
+
+	/**
+	 * Records that a pattern was frequent, thus extended, and gives it the
+	 * next rank.
+	 * @param pattern the text of the pattern
+	 */
+	void setExtended(const string& pattern);
+
+	/**
+	 * Returns true if a pattern was extended.
+	 * @param pattern the text of the pattern
+	 */
+	bool isExtended(const string& pattern) const;
+
+	/**
+	 * Returns the extended patterns, in the order of their ranks.
+	 * @param ranked the extended patterns
+	 */
+	void getExtended(vector<pair<const string*, const Entry*> >& ranked) const;
+
+	/**
+	 * Returns true if a pattern that was not extended may become frequent
+	 * once the trees of a state of appended trees are added.
+	 * @param appended the state of the appended trees
+	 * @param support the min support
+	 */
+	bool canBecomeFrequent(const IncrementalState& appended, int support) const;
+
+	/**
+	 * Returns true if the patterns whose last node has a label are recorded
+	 * in all the trees containing the label but the first ones.
+	 * @param label a label of the dataset
+	 */
+	bool isRecorded(int label) const;
+
+	/**
+	 * Returns an upper bound of the number of trees containing a label in
+	 * which the patterns with the label are not recorded.
+	 * @param label a label of the dataset
+	 */
+	int getUnknownTrees(int label) const;
+
+	/**
+	 * Adds the patterns and the trees of a state computed on trees appended
+	 * to the dataset of this state.
+	 * @param appended the state of the appended trees
+	 */
+	void append(const IncrementalState& appended);
+
+	/**
+	 * Removes the first trees of the dataset. The supports of the patterns
+	 * only count the following trees.
+	 * @param nbRemoved the number of removed trees
+	 * @param removedLabels the number of removed trees containing each label
+	 */
+	void removeTrees(int nbRemoved, const map<int, int>& removedLabels);
+
+	/**
+	 * Releases the memory used by the removed trees. The patterns that are
+	 * not extended and no longer occur are forgotten.
+	 */
+	void forgetRemovedTrees();
+
+	/**
+	 * Removes all patterns and labels.
+	 */
+	void clear();
+
+	/**
+	 * Reads a state written by write.
+	 * @param fileName the name of the file
+	 * @return false if the file cannot be read
+	 */
+	bool read(const string& fileName);
+
+	/**
+	 * Writes the state in a file.
+	 * @param fileName the name of the file
+	 * @return false if the file cannot be written
+	 */
+	bool write(const string& fileName) const;
+
+	// the options of the search, a state is only reused with the same options
+	string signature;
+	// the number of trees of the dataset, including the removed ones
+	int nbTrees;
+	// the index of the first tree that is not removed
+	int firstTree;
+	// the number of trees containing each label of the dataset
+	map<int, int> labelTrees;
+	// the number of first trees containing each label in which the patterns
+	// whose last node has the label are not recorded, as the label was not
+	// frequent enough
+	map<int, int> unknownLabelTrees;
+
+private:
+	unordered_map<string, Entry> patterns;
+	int nbExtended;
+};
+
+#endif /* INCREMENTALSTATE_H_ */
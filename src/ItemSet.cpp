@@ -0,0 +1,78 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// A sorted set of items stored in a small inline buffer.                     |
+//----------------------------------------------------------------------------+
+
+#include "ItemSet.h"
+
+ItemSet::ItemSet(const ItemSet& is) {
+	nbItems = is.nbItems;
+	capacity = INLINE_CAPACITY;
+	if (nbItems > INLINE_CAPACITY) {
+		capacity = nbItems;
+		heapItems = new int[capacity];
+	}
+	std::copy(is.begin(), is.end(), data());
+}
+
+ItemSet& ItemSet::operator=(const ItemSet& is) {
+	if (this == &is) {
+		return (*this);
+	}
+	if (is.nbItems > capacity) {
+		if (capacity > INLINE_CAPACITY)
+			delete[] heapItems;
+		capacity = is.nbItems;
+		heapItems = new int[capacity];
+	}
+	nbItems = is.nbItems;
+	std::copy(is.begin(), is.end(), data());
+	return (*this);
+}
+
+bool ItemSet::insert(int item) {
+	int* first = data();
+	int* pos = std::lower_bound(first, first + nbItems, item);
+	if ((pos != first + nbItems) && (*pos == item)) {
+		return (false);
+	}
+	int index = pos - first;
+	if (nbItems == capacity) {
+		int newCapacity = capacity * 2;
+		int* items = new int[newCapacity];
+		std::copy(first, first + nbItems, items);
+		if (capacity > INLINE_CAPACITY)
+			delete[] heapItems;
+		heapItems = items;
+		capacity = newCapacity;
+		first = items;
+	}
+	std::copy_backward(first + index, first + nbItems, first + nbItems + 1);
+	first[index] = item;
+	nbItems += 1;
+	return (true);
+}
+
+int ItemSet::erase(int item) {
+	int* first = data();
+	int* pos = std::lower_bound(first, first + nbItems, item);
+	if ((pos == first + nbItems) || (*pos != item)) {
+		return (0);
+	}
+	std::copy(pos + 1, first + nbItems, pos);
+	nbItems -= 1;
+	return (1);
+}
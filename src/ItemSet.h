@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef ITEMSET_H_
+#define ITEMSET_H_
+
+#include <iterator>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * A sorted set of items (the attributes of a node).
+ * Up to INLINE_CAPACITY items are stored inside the object, larger sets
+ * spill to the heap. Iteration, comparison and inclusion tests work on a
+ * contiguous sorted array and follow the semantics of std::set<int>.
+ */
+class ItemSet {
+public:
+	typedef const int* const_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	/**
+	 * Empty constructor.
+	 */
+	ItemSet() : nbItems(0), capacity(INLINE_CAPACITY) {};
+
+	/**
+	 * Copy constructor.
+	 */
+	ItemSet(const ItemSet&);
+
+	/**
+	 * Assignment operator.
+	 */
+	ItemSet& operator=(const ItemSet&);
+
+	/**
+	 * Destructor.
+	 */
+	~ItemSet() {
+		if (capacity > INLINE_CAPACITY)
+			delete[] heapItems;
+	};
+
+	const_iterator begin() const {return (data());};
+	const_iterator end() const {return (data() + nbItems);};
+	const_reverse_iterator rbegin() const {return (const_reverse_iterator(end()));};
+	const_reverse_iterator rend() const {return (const_reverse_iterator(begin()));};
+
+	/**
+	 * Returns the number of items
+	 */
+	int size() const {return (nbItems);};
+
+	/**
+	 * Returns true if the set contains no item
+	 */
+	bool empty() const {return (nbItems == 0);};
+
+	/**
+	 * Returns the number of occurences (0 or 1) of an item
+	 */
+	int count(int item) const {return (std::binary_search(begin(), end(), item) ? 1 : 0);};
+
+	/**
+	 * Inserts an item, keeping the items sorted.
+	 * @return true if the item was not already in the set
+	 */
+	bool insert(int item);
+
+	/**
+	 * Removes an item.
+	 * @return the number of removed items (0 or 1)
+	 */
+	int erase(int item);
+
+	/**
+	 * Removes all items.
+	 */
+	void clear() {nbItems = 0;};
+
+	bool operator==(const ItemSet& is) const {
+		return ((nbItems == is.nbItems) && std::equal(begin(), end(), is.begin()));
+	};
+	bool operator!=(const ItemSet& is) const {return (!(*this == is));};
+	bool operator<(const ItemSet& is) const {
+		return (std::lexicographical_compare(begin(), end(), is.begin(), is.end()));
+	};
+	bool operator>(const ItemSet& is) const {return (is < *this);};
+	bool operator<=(const ItemSet& is) const {return (!(is < *this));};
+	bool operator>=(const ItemSet& is) const {return (!(*this < is));};
+
+private:
+	static const int INLINE_CAPACITY = 6;
+
+	int* data() {return (capacity > INLINE_CAPACITY ? heapItems : inlineItems);};
+	const int* data() const {return (capacity > INLINE_CAPACITY ? heapItems : inlineItems);};
+
+	int nbItems;
+	int capacity;
+	union {
+		int inlineItems[INLINE_CAPACITY];
+		int* heapItems;
+	};
+};
+
+#endif /* ITEMSET_H_ */
@@ -0,0 +1,124 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class indexing candidates for the search of itemset supersets.             |
+//----------------------------------------------------------------------------+
+
+#include "ItemsetClosureIndex.h"
+
+ItemsetClosureIndex::ItemsetClosureIndex() {
+}
+
+ItemsetClosureIndex::~ItemsetClosureIndex() {
+}
+
+void ItemsetClosureIndex::set(const PatternStore& patterns, int patternId,
+		int perTreeFrequency, int nbOccurences) {
+	unordered_map<int, pair<Group*, int> >::iterator loc = locations.find(patternId);
+	if (loc != locations.end()) {
+		Entry& e = loc->second.first->entries[loc->second.second];
+		e.perTreeFrequency = perTreeFrequency;
+		e.nbOccurences = nbOccurences;
+		return;
+	}
+	vector<pair<ItemSet, int> > label;
+	patterns.getLabel(patternId, label);
+	vector<int> depths(label.size());
+	for (int i = 0; i < (int) label.size(); i++) {
+		depths[i] = label[i].second;
+	}
+	Group& group = groups[depths];
+	int index = group.entries.size();
+	Entry e;
+	e.patternId = patternId;
+	e.perTreeFrequency = perTreeFrequency;
+	e.nbOccurences = nbOccurences;
+	e.removed = false;
+	group.entries.push_back(e);
+	for (int i = 0; i < (int) label.size(); i++) {
+		for (ItemSet::const_iterator it = label[i].first.begin();
+				it != label[i].first.end(); it++) {
+			group.postings[keyOf(i, *it)].push_back(index);
+		}
+	}
+	locations[patternId] = pair<Group*, int>(&group, index);
+}
+
+void ItemsetClosureIndex::remove(int patternId) {
+	unordered_map<int, pair<Group*, int> >::iterator loc = locations.find(patternId);
+	if (loc != locations.end()) {
+		// the entry stays in the posting lists
+		loc->second.first->entries[loc->second.second].removed = true;
+		locations.erase(loc);
+	}
+}
+
+pair<int, int> ItemsetClosureIndex::getInheritedCount(const PatternStore& patterns,
+		const vector<pair<ItemSet, int> >& label) const {
+	pair<int, int> count;
+	vector<int> depths(label.size());
+	for (int i = 0; i < (int) label.size(); i++) {
+		depths[i] = label[i].second;
+	}
+	map<vector<int>, Group>::const_iterator groupIt = groups.find(depths);
+	if (groupIt == groups.end()) {
+		return (count);
+	}
+	const Group& group = groupIt->second;
+
+	// the entries to test are those of the shortest posting list
+	const vector<int>* shortest = NULL;
+	for (int i = 0; i < (int) label.size(); i++) {
+		for (ItemSet::const_iterator it = label[i].first.begin();
+				it != label[i].first.end(); it++) {
+			unordered_map<long long, vector<int> >::const_iterator postingIt =
+					group.postings.find(keyOf(i, *it));
+			if (postingIt == group.postings.end()) {
+				return (count);
+			}
+			if ((shortest == NULL) || (postingIt->second.size() < shortest->size())) {
+				shortest = &postingIt->second;
+			}
+		}
+	}
+	if (shortest == NULL) {
+		return (count);
+	}
+
+	vector<pair<ItemSet, int> > candidateLabel;
+	for (vector<int>::const_iterator idx = shortest->begin(); idx != shortest->end(); idx++) {
+		const Entry& e = group.entries[*idx];
+		if (e.removed) {
+			continue;
+		}
+		patterns.getLabel(e.patternId, candidateLabel);
+		if (candidateLabel == label) {
+			continue;
+		}
+		bool superset = true;
+		for (int i = 0; i < (int) label.size(); i++) {
+			if (!includes(candidateLabel[i].first.begin(), candidateLabel[i].first.end(),
+					label[i].first.begin(), label[i].first.end())) {
+				superset = false;
+				break;
+			}
+		}
+		if (superset) {
+			count.first = max(count.first, e.perTreeFrequency);
+			count.second = max(count.second, e.nbOccurences);
+		}
+	}
+	return (count);
+}
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef ITEMSETCLOSUREINDEX_H_
+#define ITEMSETCLOSUREINDEX_H_
+
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include "ItemSet.h"
+#include "PatternStore.h"
+
+using namespace std;
+
+/**
+ * An index of the candidates whose support is known, used to find the
+ * candidates having the same topology as a pattern and, for each node, a
+ * superset of its items.
+ * Candidates are grouped by depth sequence. Inside a group, each pair
+ * (position, item) is associated to the list of candidates containing the
+ * item at this position, so that a query only scans the shortest list of
+ * the pairs of the pattern.
+ */
+class ItemsetClosureIndex {
+public:
+	ItemsetClosureIndex();
+	virtual ~ItemsetClosureIndex();
+
+	/**
+	 * Adds a candidate or updates its support.
+	 * @param patterns the store containing the candidate
+	 * @param patternId the id of the candidate
+	 * @param perTreeFrequency the support of the candidate
+	 * @param nbOccurences the number of occurences of the candidate
+	 */
+	void set(const PatternStore& patterns, int patternId, int perTreeFrequency,
+			int nbOccurences);
+
+	/**
+	 * Removes a candidate, if it is indexed.
+	 * @param patternId the id of the candidate
+	 */
+	void remove(int patternId);
+
+	/**
+	 * Returns the maximum support and number of occurences of the indexed
+	 * candidates with the same depths as a pattern, whose nodes contain the
+	 * items of the nodes of the pattern, and that are different from it.
+	 * @param patterns the store containing the indexed candidates
+	 * @param label the sequence of nodes of a pattern
+	 */
+	pair<int, int> getInheritedCount(const PatternStore& patterns,
+			const vector<pair<ItemSet, int> >& label) const;
+
+private:
+	struct Entry {
+		int patternId;
+		int perTreeFrequency;
+		int nbOccurences;
+		bool removed;
+	};
+	struct Group {
+		vector<Entry> entries;
+		// entries containing an item at a position, keyed by (position, item)
+		unordered_map<long long, vector<int> > postings;
+	};
+	static long long keyOf(int position, int item) {
+		return (((long long) position << 32) | (unsigned int) item);
+	};
+	map<vector<int>, Group> groups;
+	// group and index of entry of each indexed candidate
+	unordered_map<int, pair<Group*, int> > locations;
+};
+
+#endif /* ITEMSETCLOSUREINDEX_H_ */
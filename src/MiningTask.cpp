@@ -0,0 +1,39 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class storing a candidate exchanged between workers.                       |
+//----------------------------------------------------------------------------+
+
+#include "MiningTask.h"
+
+MiningTask::MiningTask() {
+	pathOffsets.push_back(0);
+}
+
+MiningTask::~MiningTask() {
+}
+
+void MiningTask::addEmbedding(int treeId, const vector<int>& path) {
+	trees.push_back(treeId);
+	pathNodes.insert(pathNodes.end(), path.begin(), path.end());
+	pathOffsets.push_back(pathNodes.size());
+}
+
+void MiningTask::clear() {
+	label.clear();
+	trees.clear();
+	pathOffsets.resize(1);
+	pathNodes.clear();
+}
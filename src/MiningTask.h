@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef MININGTASK_H_
+#define MININGTASK_H_
+
+#include <vector>
+#include "ItemSet.h"
+
+using namespace std;
+
+/**
+ * A candidate detached from the structures of the worker that generated it,
+ * so that its extension can be performed by another worker.
+ * The embeddings are stored as full paths of node ids.
+ */
+class MiningTask {
+public:
+	MiningTask();
+	virtual ~MiningTask();
+
+	/**
+	 * Returns the number of embeddings
+	 */
+	int size() const {return (trees.size());};
+
+	/**
+	 * Adds an embedding.
+	 * @param treeId the id of the tree containing the embedding
+	 * @param path the ids of the nodes of the embedding
+	 */
+	void addEmbedding(int treeId, const vector<int>& path);
+
+	/**
+	 * Removes the content of the task.
+	 */
+	void clear();
+
+	// the sequence of nodes of the candidate
+	vector<pair<ItemSet, int> > label;
+	// tree of each embedding
+	vector<int> trees;
+	// first node of each embedding in pathNodes (one extra element at the end)
+	vector<int> pathOffsets;
+	vector<int> pathNodes;
+};
+
+#endif /* MININGTASK_H_ */
@@ -24,13 +24,13 @@
 #include "NodeInfo.h"
 
 NodeInfo::NodeInfo() {
-	this->labels = set<int>();
+	this->labels = ItemSet();
 	this->childNodes = set<int>();
 	this->depth = -1;
 }
 
 NodeInfo::NodeInfo(int id, int depth) {
-	this->labels = set<int>();
+	this->labels = ItemSet();
 	this->childNodes = set<int>();
 	this->depth = depth;
 }
@@ -18,6 +18,7 @@
 #define NODEINFO_H_
 
 #include <set>
+#include "ItemSet.h"
 
 using namespace std;
 
@@ -45,7 +46,7 @@ public:
 	 */
 	bool isFrequent() const {return (labels.size() > 0);};
 //private:
-	std::set<int> labels;
+	ItemSet labels;
 	std::set<int> childNodes;
 	int depth;
 };
@@ -0,0 +1,167 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class storing hash-consed patterns.                                        |
+//----------------------------------------------------------------------------+
+
+#include "PatternStore.h"
+
+PatternStore::PatternStore() {
+	slots.assign(1024, -1);
+	nbPatterns = 0;
+}
+
+PatternStore::~PatternStore() {
+}
+
+size_t PatternStore::hashOf(int parentId, const pair<ItemSet, int>& node) {
+	size_t h = (size_t) (parentId + 1) * 0x9E3779B97F4A7C15ULL;
+	h ^= (size_t) node.second + 0x7F4A7C15 + (h << 6) + (h >> 2);
+	for (ItemSet::const_iterator it = node.first.begin();
+			it != node.first.end(); it++) {
+		h ^= (size_t) *it + 0x9E3779B9 + (h << 6) + (h >> 2);
+	}
+	return (h);
+}
+
+int PatternStore::lookup(int parentId, const pair<ItemSet, int>& node,
+		size_t hash) const {
+	size_t mask = slots.size() - 1;
+	for (size_t i = hash & mask; slots[i] != -1; i = (i + 1) & mask) {
+		const Entry& e = entries[slots[i]];
+		if (e.hash == hash && e.parent == parentId && e.node == node) {
+			return (slots[i]);
+		}
+	}
+	return (-1);
+}
+
+void PatternStore::insertSlot(int id) {
+	size_t mask = slots.size() - 1;
+	size_t i = entries[id].hash & mask;
+	while (slots[i] != -1) {
+		i = (i + 1) & mask;
+	}
+	slots[i] = id;
+}
+
+void PatternStore::eraseSlot(int id) {
+	size_t mask = slots.size() - 1;
+	size_t i = entries[id].hash & mask;
+	while (slots[i] != id) {
+		i = (i + 1) & mask;
+	}
+	// backward shift deletion keeps probe sequences unbroken
+	size_t j = i;
+	while (true) {
+		slots[i] = -1;
+		while (true) {
+			j = (j + 1) & mask;
+			if (slots[j] == -1) {
+				return;
+			}
+			size_t home = entries[slots[j]].hash & mask;
+			if (((j - home) & mask) >= ((j - i) & mask)) {
+				break;
+			}
+		}
+		slots[i] = slots[j];
+		i = j;
+	}
+}
+
+void PatternStore::grow() {
+	slots.assign(slots.size() * 2, -1);
+	for (int id = 0; id < (int) entries.size(); id++) {
+		if (entries[id].refCount > 0) {
+			insertSlot(id);
+		}
+	}
+}
+
+int PatternStore::intern(int parentId, const pair<ItemSet, int>& node) {
+	size_t hash = hashOf(parentId, node);
+	int id = lookup(parentId, node, hash);
+	if (id != -1) {
+		entries[id].refCount += 1;
+		return (id);
+	}
+	if ((size_t) (nbPatterns + 1) * 2 > slots.size()) {
+		grow();
+	}
+	if (freeEntries.empty()) {
+		id = entries.size();
+		entries.push_back(Entry());
+	} else {
+		id = freeEntries.back();
+		freeEntries.pop_back();
+	}
+	Entry& e = entries[id];
+	e.parent = parentId;
+	e.node = node;
+	e.hash = hash;
+	e.size = (parentId == -1) ? 1 : entries[parentId].size + 1;
+	e.refCount = 1;
+	if (parentId != -1) {
+		entries[parentId].refCount += 1;
+	}
+	insertSlot(id);
+	nbPatterns += 1;
+	return (id);
+}
+
+int PatternStore::find(int parentId, const pair<ItemSet, int>& node) const {
+	return (lookup(parentId, node, hashOf(parentId, node)));
+}
+
+int PatternStore::find(const vector<pair<ItemSet, int> >& labelPath) const {
+	int id = -1;
+	for (int i = 0; i < (int) labelPath.size(); i++) {
+		id = find(id, labelPath[i]);
+		if (id == -1) {
+			return (-1);
+		}
+	}
+	return (id);
+}
+
+void PatternStore::acquire(int id) {
+	entries[id].refCount += 1;
+}
+
+void PatternStore::release(int id) {
+	while (id != -1) {
+		Entry& e = entries[id];
+		e.refCount -= 1;
+		if (e.refCount > 0) {
+			return;
+		}
+		eraseSlot(id);
+		int parentId = e.parent;
+		e.node.first.clear();
+		freeEntries.push_back(id);
+		nbPatterns -= 1;
+		id = parentId;
+	}
+}
+
+void PatternStore::getLabel(int id,
+		vector<pair<ItemSet, int> >& labelPath) const {
+	labelPath.resize(id == -1 ? 0 : entries[id].size);
+	for (int i = (int) labelPath.size() - 1; i >= 0; i--) {
+		labelPath[i] = entries[id].node;
+		id = entries[id].parent;
+	}
+}
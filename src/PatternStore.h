@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef PATTERNSTORE_H_
+#define PATTERNSTORE_H_
+
+#include <vector>
+#include <cstddef>
+#include "ItemSet.h"
+
+using namespace std;
+
+/**
+ * A store of hash-consed patterns.
+ * Each pattern is identified by a compact integer and is kept as the pair
+ * (id of the pattern without its last node, last node). The empty pattern
+ * has the id -1. Patterns are reference counted: a pattern stays in the
+ * store as long as it is held by a candidate or is the prefix of another
+ * stored pattern.
+ */
+class PatternStore {
+public:
+	PatternStore();
+	virtual ~PatternStore();
+
+	/**
+	 * Returns the id of the pattern made of a prefix and a new last node,
+	 * creating it if needed. The caller holds a reference on the returned id.
+	 * @param parentId the id of the prefix (-1 for the empty pattern)
+	 * @param node the last node of the pattern
+	 * @return the id of the pattern
+	 */
+	int intern(int parentId, const pair<ItemSet, int>& node);
+
+	/**
+	 * Looks up a pattern without creating it.
+	 * @param parentId the id of the prefix (-1 for the empty pattern)
+	 * @param node the last node of the pattern
+	 * @return the id of the pattern ; -1 if it is not stored
+	 */
+	int find(int parentId, const pair<ItemSet, int>& node) const;
+
+	/**
+	 * Looks up a pattern given as a full sequence of nodes.
+	 * @param labelPath the sequence of nodes of the pattern
+	 * @return the id of the pattern ; -1 if it is not stored
+	 */
+	int find(const vector<pair<ItemSet, int> >& labelPath) const;
+
+	/**
+	 * Adds a reference on a pattern.
+	 */
+	void acquire(int id);
+
+	/**
+	 * Removes a reference on a pattern. Patterns that are no longer
+	 * referenced are removed from the store.
+	 */
+	void release(int id);
+
+	/**
+	 * Rebuilds the sequence of nodes of a pattern.
+	 * @param id the id of the pattern
+	 * @param labelPath the sequence of nodes of the pattern
+	 */
+	void getLabel(int id, vector<pair<ItemSet, int> >& labelPath) const;
+
+	/**
+	 * Returns the id of the pattern without its last node
+	 */
+	int getParent(int id) const {return (entries[id].parent);};
+
+	/**
+	 * Returns the last node of the pattern
+	 */
+	const pair<ItemSet, int>& getNode(int id) const {return (entries[id].node);};
+
+	/**
+	 * Returns the number of nodes of the pattern
+	 */
+	int getSize(int id) const {return (entries[id].size);};
+
+	/**
+	 * Returns the number of patterns in the store
+	 */
+	int size() const {return (nbPatterns);};
+
+private:
+	struct Entry {
+		int parent;
+		pair<ItemSet, int> node;
+		size_t hash;
+		int size;
+		int refCount;
+	};
+
+	static size_t hashOf(int parentId, const pair<ItemSet, int>& node);
+	int lookup(int parentId, const pair<ItemSet, int>& node, size_t hash) const;
+	void insertSlot(int id);
+	void eraseSlot(int id);
+	void grow();
+
+	vector<Entry> entries;
+	vector<int> freeEntries;
+	// open addressing table (linear probing) of entry indexes, -1 if empty
+	vector<int> slots;
+	int nbPatterns;
+};
+
+#endif /* PATTERNSTORE_H_ */
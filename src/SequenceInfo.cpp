@@ -18,27 +18,11 @@
 
 #include "SequenceInfo.h"
 
-SequenceInfo::SequenceInfo(int nbTree, vector<int>& pathList) {
+SequenceInfo::SequenceInfo(int nbTree, int embedding, int last) {
 	this->nbTree = nbTree;
-	this->nbOfIdenticalSubTree =1;
-	this->pathList = pathList;
+	this->embedding = embedding;
+	this->last = last;
 }
 
-bool SequenceInfo::operator==(const SequenceInfo &si) const {
-	return ((nbTree == si.nbTree) && (pathList == si.pathList));
-}
-
-bool SequenceInfo::operator<(const SequenceInfo &si) const {
-	if (nbTree < si.nbTree)
-		return (true);
-	if (nbTree > si.nbTree)
-		return (false);
-	if (pathList < si.pathList)
-		return (true);
-	return (false);
-}
-
-
 SequenceInfo::~SequenceInfo() {
 }
-
@@ -17,47 +17,28 @@
 #ifndef SEQUENCEINFO_H_
 #define SEQUENCEINFO_H_
 
-#include <string>
-#include <vector>
-#include <set>
-
 using namespace std;
 
 class SequenceInfo {
 
 private:
 	int nbTree;
-	int nbOfIdenticalSubTree;
-public:
-	vector<int> pathList;
+	int embedding;
+	int last;
 
 public:
 	/**
 	 * Constructor
 	 * @param nbTree the index of the tree in which the current subtree is found
-	 * @param pathList the index of nodes included in the subtree
+	 * @param embedding the index of the subtree in the EmbeddingStore
+	 * @param last the index of the last node included in the subtree
 	 */
-	SequenceInfo(int, vector<int>&);
+	SequenceInfo(int, int, int);
 
 	/**
-	 * Destructor.
+	 * Destructor (not virtual: instances are stored by value in large vectors).
 	 */
-	virtual ~SequenceInfo();
-
-
-	/**
-	 * Equal operator.
-	 * @param an instance of SequenceInfo
-	 * @return true if the two objects contain the same information.
-	 */
-	bool operator==(const SequenceInfo &) const;
-
-	/**
-	 * Redefinition of the inferior operator.
-	 * @param si a SequenceInfo
-	 * @return true if the current instance is strictly lower than the given parameter
-	 */
-	bool operator<(const SequenceInfo &) const;
+	~SequenceInfo();
 
 	/**
 	 * Returns nbTree
@@ -65,21 +46,13 @@ public:
 	const int getNbTree() const {return (nbTree);};
 
 	/**
-	 * Returns pathList
+	 * Returns the index of the subtree in the EmbeddingStore
 	 */
-	const vector<int> getPathList() const {return (pathList);};
+	const int getEmbedding() const {return (embedding);};
 
 	/**
-	 * Returns size of pathList
-	 */
-	const int getSize() const {return (pathList.size());};
-	/**
-	 * Returns last element of pathList
-	 */
-	const int getLast() const {return (pathList.back());};
-	/**
-	 * Returns nth element of pathList
+	 * Returns the index of the last node of the subtree
 	 */
-	const int getElementAt(int n) const {return (pathList[n]);};
+	const int getLast() const {return (last);};
 };
 #endif /* SEQUENCEINFO_H_ */
@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class indexing candidates by their one-node-deleted patterns.              |
+//----------------------------------------------------------------------------+
+
+#include "StructuralClosureIndex.h"
+
+StructuralClosureIndex::StructuralClosureIndex() {
+}
+
+StructuralClosureIndex::~StructuralClosureIndex() {
+}
+
+size_t StructuralClosureIndex::hashOf(const vector<pair<ItemSet, int> >& label) {
+	size_t h = label.size();
+	for (vector<pair<ItemSet, int> >::const_iterator node = label.begin();
+			node != label.end(); node++) {
+		h ^= (size_t) node->second + 0x7F4A7C15 + (h << 6) + (h >> 2);
+		for (ItemSet::const_iterator it = node->first.begin();
+				it != node->first.end(); it++) {
+			h ^= (size_t) *it + 0x9E3779B9 + (h << 6) + (h >> 2);
+		}
+	}
+	return (h);
+}
+
+void StructuralClosureIndex::deleteNode(const vector<pair<ItemSet, int> >& label,
+		int pos, vector<pair<ItemSet, int> >& deleted) {
+	deleted = label;
+	int depth = deleted[pos].second;
+	deleted.erase(deleted.begin() + pos);
+	for (int j = pos; j < (int) deleted.size(); j++) {
+		if (deleted[j].second > depth) {
+			deleted[j].second -= 1;
+		} else {
+			break;
+		}
+	}
+}
+
+void StructuralClosureIndex::set(const PatternStore& patterns, int patternId,
+		int perTreeFrequency, int nbOccurences) {
+	unordered_map<int, Entry>::iterator entryIt = entries.find(patternId);
+	if (entryIt != entries.end()) {
+		entryIt->second.perTreeFrequency = perTreeFrequency;
+		entryIt->second.nbOccurences = nbOccurences;
+		return;
+	}
+	Entry& e = entries[patternId];
+	e.perTreeFrequency = perTreeFrequency;
+	e.nbOccurences = nbOccurences;
+	vector<pair<ItemSet, int> > label;
+	patterns.getLabel(patternId, label);
+	vector<pair<ItemSet, int> > deleted;
+	for (int i = 0; i < (int) label.size(); i++) {
+		deleteNode(label, i, deleted);
+		e.keys.push_back(hashOf(deleted));
+	}
+	std::sort(e.keys.begin(), e.keys.end());
+	e.keys.erase(std::unique(e.keys.begin(), e.keys.end()), e.keys.end());
+	for (vector<size_t>::const_iterator key = e.keys.begin(); key != e.keys.end(); key++) {
+		buckets[*key].push_back(patternId);
+	}
+}
+
+void StructuralClosureIndex::remove(int patternId) {
+	unordered_map<int, Entry>::iterator entryIt = entries.find(patternId);
+	if (entryIt == entries.end()) {
+		return;
+	}
+	for (vector<size_t>::const_iterator key = entryIt->second.keys.begin();
+			key != entryIt->second.keys.end(); key++) {
+		unordered_map<size_t, vector<int> >::iterator bucket = buckets.find(*key);
+		vector<int>::iterator pos = std::find(bucket->second.begin(), bucket->second.end(), patternId);
+		*pos = bucket->second.back();
+		bucket->second.pop_back();
+		if (bucket->second.empty()) {
+			buckets.erase(bucket);
+		}
+	}
+	entries.erase(entryIt);
+}
+
+pair<int, int> StructuralClosureIndex::getInheritedCount(const PatternStore& patterns,
+		const vector<pair<ItemSet, int> >& label) const {
+	pair<int, int> count;
+	unordered_map<size_t, vector<int> >::const_iterator bucket = buckets.find(hashOf(label));
+	if (bucket == buckets.end()) {
+		return (count);
+	}
+	vector<pair<ItemSet, int> > candidateLabel;
+	vector<pair<ItemSet, int> > deleted;
+	for (vector<int>::const_iterator id = bucket->second.begin();
+			id != bucket->second.end(); id++) {
+		const Entry& e = entries.find(*id)->second;
+		patterns.getLabel(*id, candidateLabel);
+		if (candidateLabel.size() != label.size() + 1) {
+			continue;
+		}
+		for (int i = 0; i < (int) candidateLabel.size(); i++) {
+			deleteNode(candidateLabel, i, deleted);
+			if (deleted == label) {
+				count.first = max(count.first, e.perTreeFrequency);
+				count.second = max(count.second, e.nbOccurences);
+				break;
+			}
+		}
+	}
+	return (count);
+}
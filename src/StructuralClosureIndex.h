@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef STRUCTURALCLOSUREINDEX_H_
+#define STRUCTURALCLOSUREINDEX_H_
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "ItemSet.h"
+#include "PatternStore.h"
+
+using namespace std;
+
+/**
+ * An index of the candidates whose support is known, used to find the
+ * candidates from which a pattern is obtained by deleting one node.
+ * Each candidate is registered under the hash of each pattern obtained by
+ * deleting one of its nodes (the descendants of the deleted node move up
+ * one level).
+ */
+class StructuralClosureIndex {
+public:
+	StructuralClosureIndex();
+	virtual ~StructuralClosureIndex();
+
+	/**
+	 * Adds a candidate or updates its support.
+	 * @param patterns the store containing the candidate
+	 * @param patternId the id of the candidate
+	 * @param perTreeFrequency the support of the candidate
+	 * @param nbOccurences the number of occurences of the candidate
+	 */
+	void set(const PatternStore& patterns, int patternId, int perTreeFrequency,
+			int nbOccurences);
+
+	/**
+	 * Removes a candidate, if it is indexed.
+	 * @param patternId the id of the candidate
+	 */
+	void remove(int patternId);
+
+	/**
+	 * Returns the maximum support and number of occurences of the indexed
+	 * candidates from which a pattern is obtained by deleting one node.
+	 * @param patterns the store containing the indexed candidates
+	 * @param label the sequence of nodes of a pattern
+	 */
+	pair<int, int> getInheritedCount(const PatternStore& patterns,
+			const vector<pair<ItemSet, int> >& label) const;
+
+	/**
+	 * Builds the pattern obtained by deleting a node.
+	 * @param label the sequence of nodes of a pattern
+	 * @param pos the position of the deleted node
+	 * @param deleted the resulting sequence of nodes
+	 */
+	static void deleteNode(const vector<pair<ItemSet, int> >& label, int pos,
+			vector<pair<ItemSet, int> >& deleted);
+
+private:
+	struct Entry {
+		int perTreeFrequency;
+		int nbOccurences;
+		// the distinct hashes under which the candidate is registered
+		vector<size_t> keys;
+	};
+	static size_t hashOf(const vector<pair<ItemSet, int> >& label);
+	unordered_map<int, Entry> entries;
+	unordered_map<size_t, vector<int> > buckets;
+};
+
+#endif /* STRUCTURALCLOSUREINDEX_H_ */
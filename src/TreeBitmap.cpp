@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+// Class storing the set of trees of a candidate as a bitmap.                 |
+//----------------------------------------------------------------------------+
+
+#include <algorithm>
+#include "TreeBitmap.h"
+
+TreeBitmap::TreeBitmap() {
+	firstWord = 0;
+}
+
+TreeBitmap::~TreeBitmap() {
+}
+
+void TreeBitmap::reserve(int word) {
+	if (words.empty()) {
+		firstWord = word;
+		words.push_back(0);
+	} else if (word < firstWord) {
+		words.insert(words.begin(), firstWord - word, 0);
+		firstWord = word;
+	} else {
+		words.resize(word - firstWord + 1, 0);
+	}
+}
+
+void TreeBitmap::merge(const TreeBitmap& other) {
+	if (other.words.empty()) {
+		return;
+	}
+	reserve(other.firstWord);
+	reserve(other.firstWord + other.words.size() - 1);
+	for (int i = 0; i < (int) other.words.size(); i++) {
+		words[other.firstWord + i - firstWord] |= other.words[i];
+	}
+}
+
+void TreeBitmap::merge(const TreeBitmap& other, int offset) {
+	if ((offset & 63) == 0) {
+		TreeBitmap shifted(other);
+		shifted.firstWord += offset >> 6;
+		merge(shifted);
+		return;
+	}
+	for (int i = 0; i < (int) other.words.size(); i++) {
+		uint64_t word = other.words[i];
+		while (word != 0) {
+			add(((other.firstWord + i) << 6) + __builtin_ctzll(word) + offset);
+			word &= word - 1;
+		}
+	}
+}
+
+int TreeBitmap::count(int firstTree) const {
+	int nbTrees = 0;
+	int first = (firstTree >> 6) - firstWord;
+	for (int i = (first > 0 ? first : 0); i < (int) words.size(); i++) {
+		uint64_t word = words[i];
+		if (i == first) {
+			// trees of the first word below firstTree
+			word &= ~((((uint64_t) 1) << (firstTree & 63)) - 1);
+		}
+		nbTrees += __builtin_popcountll(word);
+	}
+	return (nbTrees);
+}
+
+int TreeBitmap::countCommon(const TreeBitmap& other, int firstTree) const {
+	int nbTrees = 0;
+	int first = max(max(firstWord, other.firstWord), firstTree >> 6);
+	int last = min(firstWord + (int) words.size(), other.firstWord + (int) other.words.size());
+	for (int i = first; i < last; i++) {
+		uint64_t word = words[i - firstWord] & other.words[i - other.firstWord];
+		if (i == (firstTree >> 6)) {
+			// trees of the first word below firstTree
+			word &= ~((((uint64_t) 1) << (firstTree & 63)) - 1);
+		}
+		nbTrees += __builtin_popcountll(word);
+	}
+	return (nbTrees);
+}
+
+void TreeBitmap::removeBefore(int firstTree) {
+	int first = (firstTree >> 6) - firstWord;
+	if (first >= (int) words.size()) {
+		clear();
+		return;
+	}
+	if (first < 0) {
+		return;
+	}
+	words.erase(words.begin(), words.begin() + first);
+	firstWord += first;
+	// trees of the first word below firstTree
+	words[0] &= ~((((uint64_t) 1) << (firstTree & 63)) - 1);
+}
+
+void TreeBitmap::clear() {
+	vector<uint64_t>().swap(words);
+	firstWord = 0;
+}
+
+void TreeBitmap::swap(TreeBitmap& other) {
+	words.swap(other.words);
+	std::swap(firstWord, other.firstWord);
+}
+
+void TreeBitmap::write(ostream& out) const {
+	out << firstWord << " " << words.size() << hex;
+	for (int i = 0; i < (int) words.size(); i++) {
+		out << " " << words[i];
+	}
+	out << dec;
+}
+
+bool TreeBitmap::read(istream& in) {
+	int nbWords = 0;
+	if (!(in >> firstWord >> nbWords) || (nbWords < 0)) {
+		return (false);
+	}
+	words.resize(nbWords);
+	in >> hex;
+	for (int i = 0; i < nbWords; i++) {
+		in >> words[i];
+	}
+	in >> dec;
+	return (!in.fail());
+}
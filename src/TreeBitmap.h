@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------+
+//   This file is part of AADAGE                                              |
+//                                                                            |
+//   AADAGE is free software: you can redistribute it and/or modify it        |
+//   under the terms of the GNU General Public License as published by        |
+//   the Free Software Foundation, either version 3 of the License, or        |
+//   (at your option) any later version.                                      |
+//   You should have received a copy of the GNU General Public License        |
+//   along with AADAGE. If not, see <http://www.gnu.org/licenses/>.           |
+//                                                                            |
+//   Author: Claude Pasquier (I3S Laboratory, CNRS, Université Côte d'Azur)   |
+//   Contact: claude.pasquier@univ-cotedazur.fr                               |
+//   Created on december 2012                                                 |
+//                                                                            |
+//----------------------------------------------------------------------------+
+
+#ifndef TREEBITMAP_H_
+#define TREEBITMAP_H_
+
+#include <vector>
+#include <iostream>
+#include <stdint.h>
+
+using namespace std;
+
+/**
+ * The set of trees containing the embeddings of a candidate, one bit per
+ * tree. Only the words between the first and the last tree are stored.
+ * Embeddings are generated tree after tree, so adding a tree is usually
+ * done on the last word.
+ */
+class TreeBitmap {
+public:
+	TreeBitmap();
+	virtual ~TreeBitmap();
+
+	/**
+	 * Adds a tree.
+	 * @param tree the index of a tree
+	 */
+	void add(int tree) {
+		int word = tree >> 6;
+		if (words.empty() || (word < firstWord) || (word >= firstWord + (int) words.size())) {
+			reserve(word);
+		}
+		words[word - firstWord] |= ((uint64_t) 1) << (tree & 63);
+	};
+
+	/**
+	 * Adds the trees of another set.
+	 * @param other a set of trees
+	 */
+	void merge(const TreeBitmap& other);
+
+	/**
+	 * Adds the trees of another set, shifted by an offset.
+	 * @param other a set of trees
+	 * @param offset the value added to the index of each tree of other
+	 */
+	void merge(const TreeBitmap& other, int offset);
+
+	/**
+	 * Returns the number of trees of the set.
+	 * @param firstTree the trees with a lower index are not counted
+	 */
+	int count(int firstTree) const;
+
+	/**
+	 * Returns the number of trees that are also in another set.
+	 * @param other a set of trees
+	 * @param firstTree the trees with a lower index are not counted
+	 */
+	int countCommon(const TreeBitmap& other, int firstTree) const;
+
+	/**
+	 * Removes the trees with an index lower than a given one.
+	 * @param firstTree the index of the first tree kept
+	 */
+	void removeBefore(int firstTree);
+
+	/**
+	 * Removes all trees and releases the memory.
+	 */
+	void clear();
+
+	/**
+	 * Exchanges the content of two sets.
+	 */
+	void swap(TreeBitmap& other);
+
+	/**
+	 * Writes the set as a sequence of numbers separated by spaces.
+	 * @param out the stream to write to
+	 */
+	void write(ostream& out) const;
+
+	/**
+	 * Reads a set written by write.
+	 * @param in the stream to read from
+	 * @return false if the set cannot be read
+	 */
+	bool read(istream& in);
+
+private:
+	// makes a word part of the stored range
+	void reserve(int word);
+	int firstWord;
+	vector<uint64_t> words;
+};
+
+#endif /* TREEBITMAP_H_ */
@@ -26,15 +26,25 @@
 #include <set>
 #include <algorithm>
 #include <map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "ItemSet.h"
 #include "NodeInfo.h"
+#include "Dataset.h"
 #include "SequenceInfo.h"
 #include "Candidates.h"
+#include "MiningTask.h"
+#include "ExtensionBuffer.h"
+#include "CertificateIndex.h"
+#include "TreeBitmap.h"
+#include "IncrementalState.h"
 #include "common.h"
 #include "limits.h"
 #include <sys/time.h>
 
-#include "graph.hh"
-
 #include <unistd.h>
 
 // needed to get memory usage
@@ -48,18 +58,27 @@ bool orderedSearch = false;
 bool outputFrequentTrees = false;
 bool outputFrequency = false;
 bool countUnique = true;
+bool stopCountAtSupport = false;
 bool closedSearch = false;
 bool denseDataset = false;
 bool undirectedGraph = false;
 string inputFile;
 string patternFile;
 bool patternSearch = false;
-int absoluteSupport = 0;
+string stateFile;
+string appendedFile;
+// raised by the workers in top-k mode
+atomic<int> absoluteSupport(0);
 float relativeSupport = 0.0;
 int absoluteMaxSupport = INT_MAX;
 float relativeMaxSupport = 0.0;
 int maximumGap = -1;
 int maxDepth = -1;
+int nbThreads = 1;
+int topK = 0;
+int windowSize = 0;
+int streamStep = 1;
+bool certificateCanonicity = false;
 
 /* information on the datasets */
 int datasetSize = 0;
@@ -76,11 +95,38 @@ int useOnlyThisRoot = -1;
 
 vector<map<int, set<int> > > ignoredNodesList;
 
+/**
+ * the labels of the datasets, indexed by the dense value used internally.
+ */
+vector<int> labelDictionary;
+int nbLabels = 0;
+
 /**
  * a flag that indicates if (some) nodes contain set of items.
  */
 bool itemSetMining = false;
 
+/**
+ * the trees containing each label, used to bound the support of extensions.
+ */
+vector<TreeBitmap> labelTrees;
+
+/**
+ * the certificates of the patterns with reentrant nodes, used to test their
+ * canonical form when certificateCanonicity is set.
+ */
+CertificateIndex certificates;
+
+/**
+ * the patterns of the previous searches when a state file is used. They are
+ * recorded during a full search, or the patterns of the appended trees are
+ * recorded in appendedState while these trees are searched alone.
+ */
+IncrementalState incrementalState;
+IncrementalState appendedState;
+bool recordPatterns = false;
+bool countAppendedTrees = false;
+
 /**
  * Collects nodes from a tree serialization.
  * @param content a sequence of items representing a tree
@@ -106,7 +152,7 @@ int collectNodes(deque<string>& content, vector<NodeInfo>& nodes, int idNode,
 		nodes[idNode] = NodeInfo(idNode, depth);
 		deque<string> labels; // to store different labels
 		split(node, labels, ":"); // collect different labels in labels;
-		set<int>* labelsSet = & nodes[idNode].labels;
+		ItemSet* labelsSet = & nodes[idNode].labels;
 		for (deque<string>::const_iterator it = labels.begin(); it != labels.end();
 				it++) {
 			std::istringstream iss(*it);
@@ -136,7 +182,7 @@ int collectNodes(deque<string>& content, vector<NodeInfo>& nodes, int idNode,
  * @return the number of trees in pattern dataset ; -1 if the process fails
  */
 int processPatternFile(const string& fileName,
-		vector<vector<NodeInfo> >& patternNodes,
+		Dataset& patternNodes,
 		vector<float>& patternFrequencies) {
 	ifstream inFile(fileName.c_str());
 	int nbTrees = 0;
@@ -161,7 +207,7 @@ int processPatternFile(const string& fileName,
 			vector<NodeInfo> nodes;
 			content.erase(content.begin() + content.size() - 2, content.end());
 			collectNodes(content, nodes, -1, 0);
-			patternNodes.push_back(nodes);
+			patternNodes.addGraph(nodes);
 		}
 		inFile.close();
 		return (nbTrees);
@@ -170,6 +216,28 @@ int processPatternFile(const string& fileName,
 	}
 }
 
+/**
+ * Reads a tree written on a line in the Sleuth/treeMiner format.
+ * @param line the line
+ * @param nodes the nodes of the tree
+ * @return false if the line does not contain a tree
+ */
+bool parseTreeLine(const string& line, vector<NodeInfo>& nodes) {
+	deque<string> content; // to store tokens
+	split(line, content, " "); // split line
+	if (content.size() < 3)
+		return (false);
+	int treeId;
+	std::istringstream iss0(content[0]);
+	iss0 >> treeId;
+	int treeSize;
+	std::istringstream iss2(content[2]);
+	iss2 >> treeSize;
+	content.erase(content.begin(), content.begin() + 3);
+	collectNodes(content, nodes, -1, 0);
+	return (true);
+}
+
 /**
  * Reads input file, collects items and compute their occurences in the dataset.
  * @param fileName the name of the file that contain the data.
@@ -178,28 +246,18 @@ int processPatternFile(const string& fileName,
  * @return the number of trees in input dataset ; -1 if the process fails
  */
 int processInputFileSleuth(const string& fileName,
-		vector<vector<NodeInfo> >& allNodes) {
+		Dataset& allNodes) {
 	ifstream inFile(fileName.c_str());
 	int nbTrees = 0;
 	if (inFile.is_open()) {
 		string line;
 		while (inFile.good()) {
 			getline(inFile, line);
-			deque<string> content; // to store tokens
-			split(line, content, " "); // split line
-			if (content.size() < 3)
+			vector<NodeInfo> nodes;
+			if (!parseTreeLine(line, nodes))
 				continue;
 			nbTrees++;
-			int treeId;
-			std::istringstream iss0(content[0]);
-			iss0 >> treeId;
-			int treeSize;
-			std::istringstream iss2(content[2]);
-			iss2 >> treeSize;
-			vector<NodeInfo> nodes;
-			content.erase(content.begin(), content.begin() + 3);
-			collectNodes(content, nodes, -1, 0);
-			allNodes.push_back(nodes);
+			allNodes.addGraph(nodes);
 		}
 		inFile.close();
 		return (nbTrees);
@@ -215,7 +273,7 @@ int processInputFileSleuth(const string& fileName,
  * @return the number of trees in input dataset ; -1 if the process fails
  */
 int processInputFileHybrid(const string& fileName,
-		vector<vector<NodeInfo> >& allNodes) {
+		Dataset& allNodes) {
 	ifstream inFile(fileName.c_str());
 	int nbTrees = 0;
 	if (inFile.is_open()) {
@@ -235,7 +293,7 @@ int processInputFileHybrid(const string& fileName,
 
 				deque<string> labels; // to store different labels
 				split(line, labels, ":"); // collect different labels in labels;
-				set<int>* labelsSet = & node.labels;
+				ItemSet* labelsSet = & node.labels;
 				for (deque<string>::const_iterator it = labels.begin(); it != labels.end();
 						it++) {
 					std::istringstream iss(*it);
@@ -254,7 +312,7 @@ int processInputFileHybrid(const string& fileName,
 				deque<string> content; // to store tokens
 				split(line, content, " "); // split line
 				if (content.size() < 2) {
-					allNodes.push_back(nodes);
+					allNodes.addGraph(nodes);
 					nbTrees += 1;
 					break;
 				}
@@ -280,6 +338,69 @@ int processInputFileHybrid(const string& fileName,
 	}
 }
 
+/**
+ * Reads a node or an edge line of a graph in the Imit format.
+ * @param line the line
+ * @param nodes the nodes of the graph
+ * @param nodeId2pos the position in nodes of each node id of the graph
+ */
+void parseGraphLine(const string& line, vector<NodeInfo>& nodes,
+		map<int, int>& nodeId2pos) {
+	if ((line[0] == 'n')||(line[0] == 'v')){
+		deque<string> content; // to store tokens
+		split(line, content, " "); // split line
+		int nodeId;
+		std::istringstream iss(content[1]);
+		iss >> nodeId;
+		if (nodeId2pos.count(nodeId) == 0){
+			nodeId2pos[nodeId] = nodes.size();
+			NodeInfo node = NodeInfo(nodeId2pos[nodeId], 1);
+			nodes.push_back(node);
+		}
+
+		deque<string> labels; // to store different labels
+		split(content[2], labels, ":"); // collect different labels in labels;
+		NodeInfo* node = &nodes[nodeId2pos[nodeId]];
+		ItemSet* labelsSet = &node->labels;
+		for (deque<string>::const_iterator it = labels.begin(); it != labels.end();
+				it++) {
+			std::istringstream iss(*it);
+			int nodeLabel;
+			iss >> nodeLabel;
+			labelsSet->insert(nodeLabel);
+		}
+		if (labelsSet->size() > 1) {
+			itemSetMining = true;
+		}
+		return;
+	}
+	if ((line[0] == 'd')||(line[0] == 'e')){
+		deque<string> content; // to store tokens
+		split(line, content, " "); // split line
+		int fromNode;
+		std::istringstream iss_from(content[1]);
+		iss_from >> fromNode;
+		int toNode;
+		std::istringstream iss_to(content[2]);
+		iss_to >> toNode;
+		if (nodeId2pos.count(fromNode) == 0){
+			nodeId2pos[fromNode] = nodes.size();
+			NodeInfo node = NodeInfo(nodeId2pos[fromNode], 1);
+			nodes.push_back(node);
+		}
+		if (nodeId2pos.count(toNode) == 0){
+			nodeId2pos[toNode] = nodes.size();
+			NodeInfo node = NodeInfo(nodeId2pos[toNode], 1);
+			nodes.push_back(node);
+		}
+
+		nodes[nodeId2pos[fromNode]].childNodes.insert(nodeId2pos[toNode]);
+		if (undirectedGraph){
+			nodes[nodeId2pos[toNode]].childNodes.insert(nodeId2pos[fromNode]);
+		}
+	}
+}
+
 /**
  * Reads input file, collects items and compute their occurences in the dataset.
  * @param fileName the name of the file that contain the data.
@@ -287,14 +408,13 @@ int processInputFileHybrid(const string& fileName,
  * @return the number of trees in input dataset ; -1 if the process fails
  */
 int processInputFile(const string& fileName,
-		vector<vector<NodeInfo> >& allNodes) {
+		Dataset& allNodes) {
 	ifstream inFile(fileName.c_str());
 	int nbGraph = 0;
 	map<int, int> nodeId2pos;
 	if (inFile.is_open()) {
 		string line;
 		int graphNb;
-		int nbNode = -1;
 		vector<NodeInfo> nodes;
 		while (inFile.good()) {
 			getline(inFile, line);
@@ -302,73 +422,17 @@ int processInputFile(const string& fileName,
 				continue;
 			}
 			if ((line[0] == 'g') || (line[0] == 't') ||(line[0] == 'X')){
-				allNodes.push_back(nodes);
+				allNodes.addGraph(nodes);
 				nodes.clear();
 				nodeId2pos.clear();
 				deque<string> content; // to store tokens
 				nbGraph += 1;
-				nbNode = -1;
-				continue;
-			}
-			if ((line[0] == 'n')||(line[0] == 'v')){
-				deque<string> content; // to store tokens
-				split(line, content, " "); // split line
-				int nodeId;
-				std::istringstream iss(content[1]);
-				iss >> nodeId;
-				if (nodeId2pos.count(nodeId) == 0){
-					nbNode  += 1;
-					nodeId2pos[nodeId] = nbNode;
-					NodeInfo node = NodeInfo(nodeId2pos[nodeId], 1);
-					nodes.push_back(node);
-				}
-
-				deque<string> labels; // to store different labels
-				split(content[2], labels, ":"); // collect different labels in labels;
-				NodeInfo* node = &nodes[nodeId2pos[nodeId]];
-				set<int>* labelsSet = &node->labels;
-				for (deque<string>::const_iterator it = labels.begin(); it != labels.end();
-						it++) {
-					std::istringstream iss(*it);
-					int nodeLabel;
-					iss >> nodeLabel;
-					labelsSet->insert(nodeLabel);
-				}
-				if (labelsSet->size() > 1) {
-					itemSetMining = true;
-				}
 				continue;
 			}
-			if ((line[0] == 'd')||(line[0] == 'e')){
-				deque<string> content; // to store tokens
-				split(line, content, " "); // split line
-				int fromNode;
-				std::istringstream iss_from(content[1]);
-				iss_from >> fromNode;
-				int toNode;
-				std::istringstream iss_to(content[2]);
-				iss_to >> toNode;
-				if (nodeId2pos.count(fromNode) == 0){
-					nbNode  += 1;
-					nodeId2pos[fromNode] = nbNode;
-					NodeInfo node = NodeInfo(nodeId2pos[fromNode], 1);
-					nodes.push_back(node);
-				}
-				if (nodeId2pos.count(toNode) == 0){
-					nbNode  += 1;
-					nodeId2pos[toNode] = nbNode;
-					NodeInfo node = NodeInfo(nodeId2pos[toNode], 1);
-					nodes.push_back(node);
-				}
-
-				nodes[nodeId2pos[fromNode]].childNodes.insert(nodeId2pos[toNode]);
-				if (undirectedGraph){
-					nodes[nodeId2pos[toNode]].childNodes.insert(nodeId2pos[fromNode]);
-				}
-			}
+			parseGraphLine(line, nodes, nodeId2pos);
 		}
 		inFile.close();
-		allNodes.push_back(nodes);
+		allNodes.addGraph(nodes);
 		nbGraph += 1;
 		return (nbGraph);
 	} else {
@@ -376,7 +440,7 @@ int processInputFile(const string& fileName,
 	}
 }
 int processInputFile_bak(const string& fileName,
-		vector<vector<NodeInfo> >& allNodes) {
+		Dataset& allNodes) {
 	ifstream inFile(fileName.c_str());
 	int nbTrees = 0;
 	if (inFile.is_open()) {
@@ -398,7 +462,7 @@ int processInputFile_bak(const string& fileName,
 
 				deque<string> labels; // to store different labels
 				split(line, labels, ":"); // collect different labels in labels;
-				set<int>* labelsSet = & node.labels;
+				ItemSet* labelsSet = & node.labels;
 				for (deque<string>::const_iterator it = labels.begin(); it != labels.end();
 						it++) {
 					std::istringstream iss(*it);
@@ -417,7 +481,7 @@ int processInputFile_bak(const string& fileName,
 				deque<string> content; // to store tokens
 				split(line, content, " "); // split line
 				if (content.size() < 2) {
-					allNodes.push_back(nodes);
+					allNodes.addGraph(nodes);
 					nbTrees += 1;
 					break;
 				}
@@ -440,6 +504,26 @@ int processInputFile_bak(const string& fileName,
 	}
 }
 
+/**
+ * Determines the format of a dataset from its first line.
+ * @param line the first line of the dataset
+ * @return the data format, as getInputFormat
+ */
+int getLineFormat(const string& line) {
+	int fileFormat = -1;
+	deque<string> content; // to store tokens
+	split(line, content, " "); // split line
+	if ((content[0] == "g")||(content[0] == "t")||(content[0] == "XP"))
+		fileFormat = 3;
+	else if (content.size() == 1)
+		fileFormat = 2;
+	else if (content.size() == 2)
+		fileFormat = 3;
+	else if (content.size() > 3)
+		fileFormat = 1;
+	return (fileFormat);
+}
+
 /**
  * Reads the first line of input file and determine its format
  * @param fileName the name of the file that contain the data.
@@ -455,31 +539,44 @@ int getInputFormat(const string& fileName) {
 	if (inFile.is_open() && inFile.good()) {
 		string line;
 		getline(inFile, line);
-		deque<string> content; // to store tokens
-		split(line, content, " "); // split line
-		if ((content[0] == "g")||(content[0] == "t")||(content[0] == "XP"))
-			fileFormat = 3;
-		else if (content.size() == 1)
-			fileFormat = 2;
-		else if (content.size() == 2)
-			fileFormat = 3;
-		else if (content.size() > 3)
-			fileFormat = 1;
+		fileFormat = getLineFormat(line);
 	}
 	inFile.close();
 	return (fileFormat);
 }
 
-void collectAllChilds(const vector<NodeInfo>& listNodes, const int first, int depth, set<int>& childs) {
-	childs.insert(listNodes[first].childNodes.begin(),listNodes[first].childNodes.end());
+void collectAllChilds(const Dataset::Graph& listNodes, const int first, int depth, set<int>& childs) {
+	const Dataset::Range childNodes = listNodes[first].childNodes;
+	childs.insert(childNodes.begin(), childNodes.end());
 	if (depth == 0){
 		return;
 	}
-	for (set<int>::const_iterator it = listNodes[first].childNodes.begin(); it != listNodes[first].childNodes.end(); it++){
+	for (Dataset::Range::const_iterator it = childNodes.begin(); it != childNodes.end(); it++){
 		collectAllChilds(listNodes, *it, depth-1, childs);
 	}
 }
 
+void appendAllChilds(const Dataset::Graph& listNodes, const int first, int depth, vector<int>& childs) {
+	const Dataset::Range childNodes = listNodes[first].childNodes;
+	childs.insert(childs.end(), childNodes.begin(), childNodes.end());
+	if (depth == 0){
+		return;
+	}
+	for (Dataset::Range::const_iterator it = childNodes.begin(); it != childNodes.end(); it++){
+		appendAllChilds(listNodes, *it, depth-1, childs);
+	}
+}
+
+/**
+ * Collects the descendants of a node, up to a given depth, in a sorted vector.
+ */
+void collectAllChilds(const Dataset::Graph& listNodes, const int first, int depth, vector<int>& childs) {
+	childs.clear();
+	appendAllChilds(listNodes, first, depth, childs);
+	std::sort(childs.begin(), childs.end());
+	childs.erase(std::unique(childs.begin(), childs.end()), childs.end());
+}
+
 /**
  * Determines if there is an ancestor relationship between two nodes.
  * @param listNodes a sequence of nodes
@@ -487,7 +584,7 @@ void collectAllChilds(const vector<NodeInfo>& listNodes, const int first, int de
  * @param second the id of the second node in the sequence
  * @return true if first node is an ancestor of second node
  */
-bool isAncestor(const vector<NodeInfo>& listNodes, const int first,
+bool isAncestor(const Dataset::Graph& listNodes, const int first,
 		const int second, int maxGap) {
 	if (maxGap == 0) {
 		if (listNodes[first].childNodes.count(second) > 0) {
@@ -507,12 +604,12 @@ bool isAncestor(const vector<NodeInfo>& listNodes, const int first,
 	}
 }
 
-string serialize(const vector<pair<set<int>, int> >& label) {
+string serialize(const vector<pair<ItemSet, int> >& label) {
 	string text;
-	for (vector<pair<set<int>, int> >::const_iterator it = label.begin();
+	for (vector<pair<ItemSet, int> >::const_iterator it = label.begin();
 			it != label.end(); it++) {
-		set<int> seq = (*it).first;
-		for (set<int>::const_iterator it2 = seq.begin(); it2 != seq.end(); it2++) {
+		ItemSet seq = (*it).first;
+		for (ItemSet::const_iterator it2 = seq.begin(); it2 != seq.end(); it2++) {
 			std::ostringstream out;
 			out << *it2;
 			text += out.str() + ":";
@@ -525,7 +622,7 @@ string serialize(const vector<pair<set<int>, int> >& label) {
 	return (text);
 }
 
-vector<string> serializeSubTree(const int treeId, const int nodeId, const vector<vector<NodeInfo> >& nodes) {
+vector<string> serializeSubTree(const int treeId, const int nodeId, const Dataset& nodes) {
 	vector<string> textSet;
 	string text;
 	vector<int> orderedLabel;
@@ -537,7 +634,8 @@ vector<string> serializeSubTree(const int treeId, const int nodeId, const vector
 	}
 	textSet.push_back(text+"(");
 
-	for (set<int>::iterator it = nodes[treeId][nodeId].childNodes.begin() ; it != nodes[treeId][nodeId].childNodes.end(); it++){
+	const Dataset::Range childNodes = nodes[treeId][nodeId].childNodes;
+	for (Dataset::Range::const_iterator it = childNodes.begin() ; it != childNodes.end(); it++){
 		string text;
 		vector<int> orderedLabel;
 		orderedLabel.assign(nodes[treeId][*it].labels.begin(), nodes[treeId][*it].labels.end());
@@ -552,61 +650,183 @@ vector<string> serializeSubTree(const int treeId, const int nodeId, const vector
 	return (textSet);
 }
 
-void writeSolution(const Candidates& candidates,
-		const vector<pair<set<int>, int> >& label, const int count) {
-	vector<set<int> > labelPath;
+mutex outputMutex;
+
+/**
+ * Writes complete lines on the standard output.
+ * Lines written by concurrent workers are not interleaved.
+ * @param text the lines to write
+ */
+void writeOutput(const string& text) {
+	lock_guard<mutex> lock(outputMutex);
+	cout << text;
+}
+
+/**
+ * the best supports of the output patterns in top-k mode, the best distinct
+ * supports of the patterns found in closed searches, and the output lines of
+ * the patterns that can still be among the best ones.
+ */
+multiset<int> topSupports;
+multiset<int> topDistinctSupports;
+vector<pair<int, string> > topSolutions;
+size_t topSolutionsLimit = 0;
+
+/**
+ * Records a support in top-k mode. When topK supports have been recorded,
+ * the min support is raised to the lowest of them.
+ * Must be called with outputMutex locked.
+ * @param supports the best supports recorded
+ * @param count a support
+ */
+void addTopSupport(multiset<int>& supports, const int count) {
+	if (count < absoluteSupport) {
+		return;
+	}
+	supports.insert(count);
+	if ((int) supports.size() > topK) {
+		supports.erase(supports.begin());
+	}
+	if (((int) supports.size() == topK) && (*supports.begin() > absoluteSupport)) {
+		absoluteSupport = *supports.begin();
+	}
+}
+
+/**
+ * Records the support of a pattern in a closed search in top-k mode.
+ * Closed patterns with different supports are different, so the min support
+ * can be raised to the k-th best distinct support of the patterns found,
+ * whether they are closed or not.
+ * Must be called with outputMutex locked.
+ * @param count the support of a pattern
+ */
+void addTopDistinctSupport(const int count) {
+	if (topDistinctSupports.count(count) == 0) {
+		addTopSupport(topDistinctSupports, count);
+	}
+}
+
+/**
+ * Keeps the output line of a pattern in top-k mode.
+ * Must be called with outputMutex locked.
+ * @param count the support of the pattern
+ * @param line the output line of the pattern
+ */
+void addTopSolution(const int count, const string& line) {
+	if (count < absoluteSupport) {
+		return;
+	}
+	topSolutions.push_back(pair<int, string>(count, line));
+	addTopSupport(topSupports, count);
+	if (topSolutions.size() > topSolutionsLimit) {
+		// forgets the patterns that are no longer among the best ones
+		vector<pair<int, string> >::iterator last = topSolutions.begin();
+		for (vector<pair<int, string> >::iterator it = topSolutions.begin();
+				it != topSolutions.end(); it++) {
+			if (it->first >= absoluteSupport) {
+				std::swap(*last++, *it);
+			}
+		}
+		topSolutions.erase(last, topSolutions.end());
+		topSolutionsLimit = 2 * max(topSolutions.size(), (size_t) topK);
+	}
+}
+
+/**
+ * Writes the patterns kept in top-k mode, in the order they were found.
+ * Patterns with the same support as the last of the best ones are all written.
+ */
+void writeTopSolutions() {
+	for (vector<pair<int, string> >::const_iterator it = topSolutions.begin();
+			it != topSolutions.end(); it++) {
+		if (it->first >= absoluteSupport) {
+			cout << it->second;
+		}
+	}
+}
+
+/**
+ * Returns the label of the datasets corresponding to an internal label.
+ * @param itemSet the itemset containing the label
+ * @param label an internal label
+ * @return the original label
+ */
+int getOriginalLabel(const ItemSet& itemSet, const int label) {
+	if (*itemSet.begin() < 0) {
+		// moves up and reentrant nodes do not contain labels of the datasets
+		return (label);
+	}
+	return (labelDictionary[label]);
+}
+
+/**
+ * Returns the text of a pattern, as written in the output.
+ * @param candidates the candidates containing the pattern
+ * @param label the label of the pattern
+ */
+string getPatternText(const Candidates& candidates,
+		const vector<pair<ItemSet, int> >& label) {
+	vector<ItemSet > labelPath;
 	candidates.convertLabel(label, labelPath);
 	string labelOfSequence;
 	for (int i = 0; i < (int) labelPath.size(); i++) {
 		string l;
-		for (set<int>::const_iterator lIt = labelPath[i].begin();
+		for (ItemSet::const_iterator lIt = labelPath[i].begin();
 				lIt != labelPath[i].end(); lIt++) {
 			if (!l.empty()) {
 				l += ":";
 			}
 			std::ostringstream out;
-			out << *lIt;
+			out << getOriginalLabel(labelPath[i], *lIt);
 			l += out.str();
 		}
 		labelOfSequence += l + " ";
 	}
-	cout << labelOfSequence << "- ";
+	return (labelOfSequence);
+}
+
+/**
+ * Writes a pattern and its support.
+ * @param labelOfSequence the text of the pattern
+ * @param count the support of the pattern
+ */
+void writeSolution(const string& labelOfSequence, const int count) {
+	std::ostringstream out;
+	out << labelOfSequence << "- ";
 	if (outputFrequency) {
 		float frequency = (float) count / (float) datasetSize;
-		cout << frequency << endl;
+		out << frequency << endl;
 	} else {
-		cout << count << endl;
+		out << count << endl;
+	}
+	if (topK > 0) {
+		lock_guard<mutex> lock(outputMutex);
+		addTopSolution(count, out.str());
+		return;
 	}
+	writeOutput(out.str());
+}
+
+void writeSolution(const Candidates& candidates,
+		const vector<pair<ItemSet, int> >& label, const int count) {
+	writeSolution(getPatternText(candidates, label), count);
 }
 
 void writeSolutionForSearchPattern(const Candidates& candidates,
-		const vector<pair<set<int>, int> >& label, const int count, const int basePattern) {
-	vector<set<int> > labelPath;
-	candidates.convertLabel(label, labelPath);
-	string labelOfSequence;
-	for (int i = 0; i < (int) labelPath.size(); i++) {
-		string l;
-		for (set<int>::const_iterator lIt = labelPath[i].begin();
-				lIt != labelPath[i].end(); lIt++) {
-			if (!l.empty()) {
-				l += ":";
-			}
-			std::ostringstream out;
-			out << *lIt;
-			l += out.str();
-		}
-		labelOfSequence += l + " ";
-	}
-	cout << labelOfSequence << "- ";
+		const vector<pair<ItemSet, int> >& label, const int count, const int basePattern) {
+	string labelOfSequence = getPatternText(candidates, label);
+	std::ostringstream out;
+	out << labelOfSequence << "- ";
 	if (outputFrequency) {
 		float frequency = (float) count / (float) datasetSize;
-		cout << frequency << " (" << patternFrequencies[basePattern] << ")" << endl;
+		out << frequency << " (" << patternFrequencies[basePattern] << ")" << endl;
 	} else {
-		cout << count << " (" << patternFrequencies[basePattern] << ")" << endl;
+		out << count << " (" << patternFrequencies[basePattern] << ")" << endl;
 	}
+	writeOutput(out.str());
 }
 
-int getPreviousSibbling(const vector<pair<set<int>, int> >& label,
+int getPreviousSibbling(const vector<pair<ItemSet, int> >& label,
 		const int pos) {
 	int previousSibbling = pos - 1;
 	while (previousSibbling >= 0) {
@@ -621,7 +841,7 @@ int getPreviousSibbling(const vector<pair<set<int>, int> >& label,
 	return (previousSibbling);
 }
 
-int getParent(const vector<pair<set<int>, int> >& label, const int pos) {
+int getParent(const vector<pair<ItemSet, int> >& label, const int pos) {
 	int parentPos = pos - 1;
 	while (parentPos > 0) {
 		if (label[parentPos].second < label[pos].second) {
@@ -632,10 +852,10 @@ int getParent(const vector<pair<set<int>, int> >& label, const int pos) {
 	return (parentPos);
 }
 
-bool myComp(const set<int>& a, const set<int>& b) {
+bool myComp(const ItemSet& a, const ItemSet& b) {
 	return (a < b);
-	set<int>::const_iterator it1 = a.begin();
-	set<int>::const_iterator it2 = b.begin();
+	ItemSet::const_iterator it1 = a.begin();
+	ItemSet::const_iterator it2 = b.begin();
 	while (it1 != a.end() && it2 != b.end()) {
 		if (*it1 == *it2) {
 			it1++;
@@ -647,12 +867,12 @@ bool myComp(const set<int>& a, const set<int>& b) {
 	return (a.size() > b.size());
 }
 
-bool myComp2(const pair<set<int>, int>& a, const pair<set<int>, int>& b) {
+bool myComp2(const pair<ItemSet, int>& a, const pair<ItemSet, int>& b) {
 	if (a.second != b.second) {
 		return (a.second < b.second);
 	}
-	set<int>::const_iterator it1 = a.first.begin();
-	set<int>::const_iterator it2 = b.first.begin();
+	ItemSet::const_iterator it1 = a.first.begin();
+	ItemSet::const_iterator it2 = b.first.begin();
 	while (it1 != a.first.end() && it2 != b.first.end()) {
 		if (*it1 == *it2) {
 			it1++;
@@ -664,20 +884,6 @@ bool myComp2(const pair<set<int>, int>& a, const pair<set<int>, int>& b) {
 	return (a.first.size() > b.first.size());
 }
 
-bool myComp3(const set<int>& a, const set<int>& b) {
-	set<int>::const_iterator it1 = a.begin();
-	set<int>::const_iterator it2 = b.begin();
-	while (it1 != a.end() && it2 != b.end()) {
-		if (*it1 == *it2) {
-			it1++;
-			it2++;
-			continue;
-		}
-		return (*it1 < *it2);
-	}
-	return (a.size() > b.size());
-}
-
 /*
  *	Compare two substructures. One starting at pos1, the other at pos2
  *
@@ -688,7 +894,7 @@ bool myComp3(const set<int>& a, const set<int>& b) {
  *
  */
 
-int compareSubStructure(const vector<pair<set<int>, int> >& label, const int pos1,
+int compareSubStructure(const vector<pair<ItemSet, int> >& label, const int pos1,
 		const int pos2) {
 	int len1 = pos2 - pos1;
 	int len2 = label.size() - pos2;
@@ -709,8 +915,8 @@ int compareSubStructure(const vector<pair<set<int>, int> >& label, const int pos
 				!= (label.begin() + pos2 + j)->second);
 		if (diffDepth != 0)
 			return (-1);
-		const set<int>* label1 = &(label.begin() + pos1 + j)->first;
-		const set<int>* label2 = &(label.begin() + pos2 + j)->first;
+		const ItemSet* label1 = &(label.begin() + pos1 + j)->first;
+		const ItemSet* label2 = &(label.begin() + pos2 + j)->first;
 			if (label1 < label2)
 				return (-1);
 			else if (label1 > label2)
@@ -734,14 +940,24 @@ int compareSubStructure(const vector<pair<set<int>, int> >& label, const int pos
  *
  */
 
-int isCanonical(const vector<pair<set<int>, int> >& lab) {
-	vector<pair<set<int>, int> > label = lab;
-	for (uint i = 0 ; i < label.size() ; i++){
-		if (*label[i].first.begin() < 0){
-			int indx = -*label[i].first.begin()-1;
-			label[i].first = label[indx].first;
+int isCanonical(const vector<pair<ItemSet, int> >& lab) {
+	// reentrant nodes are replaced by the node they refer to ; the label is
+	// only copied if it contains such nodes
+	uint firstReentrant = 0;
+	while ((firstReentrant < lab.size()) && (*lab[firstReentrant].first.begin() >= 0)) {
+		firstReentrant += 1;
+	}
+	vector<pair<ItemSet, int> > replaced;
+	if (firstReentrant < lab.size()) {
+		replaced = lab;
+		for (uint i = firstReentrant ; i < replaced.size() ; i++){
+			if (*replaced[i].first.begin() < 0){
+				int indx = -*replaced[i].first.begin()-1;
+				replaced[i].first = replaced[indx].first;
+			}
 		}
 	}
+	const vector<pair<ItemSet, int> >& label = (firstReentrant < lab.size()) ? replaced : lab;
 	bool previousSibblingFound = false;
 	bool identicalRightHand = true;
 	int posLastChild = label.size() - 1;
@@ -763,15 +979,15 @@ int isCanonical(const vector<pair<set<int>, int> >& lab) {
 	return (-1);
 }
 
-int isCycleCanonical(const vector<pair<set<int>, int> >& lab) {
+int isCycleCanonical(const vector<pair<ItemSet, int> >& lab) {
 	// test of canonical form in the presence of cycles
-		vector<pair<set<int>, int> > label = lab;
+		vector<pair<ItemSet, int> > label = lab;
 		bool normalForm = true;
 		for (uint i = 0 ; i < lab.size()-2 ; i++){
 			//shift
-			pair<set<int>, int> bk1 = label.back();
+			pair<ItemSet, int> bk1 = label.back();
 			label.pop_back();
-			pair<set<int>, int> bk2 = label.back();
+			pair<ItemSet, int> bk2 = label.back();
 			label.pop_back();
 			bool stopShifting = false;
 			for (uint j = 0 ; j < label.size() ; j++){
@@ -831,86 +1047,20 @@ int isCycleCanonical(const vector<pair<set<int>, int> >& lab) {
 		}
 	}
 
-bool isCanonical2(const vector<pair<set<int>, int> >& label) {
-	if (label.size() == 1){
-		return (true);
-	}
-	map<set<int>, int> attributes2int;
-
-	vector<set<int> > attributes;
-	for (vector<pair<set<int>, int> >::const_iterator it = label.begin() ; it != label.end() ; it++) {
-		if (*it->first.begin() >= 0)
-			attributes2int[it->first]=0;
-			attributes.push_back(it->first);
-	}
-
-
-	std::sort(attributes.begin(), attributes.end(), myComp3);
-
-	for (int i = 0; i < (int) attributes.size(); i++) {
-		attributes2int[attributes[i]] = i;
-	}
-
-
-	bliss::Digraph g = bliss::Digraph(0);
-	g.set_splitting_heuristic(bliss::Digraph::shs_fm);
-
-
-	int depth = -1;
-	vector<int> path;
-	map<int, int> nodeId2vertex;
-	for (int i = 0; i < (int) label.size(); i++) {
-		int vertex;
-		if (*label[i].first.begin() < 0){
-			// an edge to an existing vertex
-			vertex = nodeId2vertex[-(*label[i].first.begin())];
-		}else{
-			vertex = g.add_vertex(attributes2int[label[i].first]);
-			nodeId2vertex[i]=vertex;
-		}
-		if (label[i].second <= depth) {
-			for (int j = label[i].second; j <= depth; j++) {
-				path.pop_back();
-			}
-		}
-
-		if (path.size() > 0) {
-			g.add_edge(path.back(), vertex);
-		}
-		path.push_back(vertex);
-		depth = label[i].second;
-	}
-	FILE *fp = fopen("f1", "w");
-	g.write_dimacs(fp);
-	fclose(fp);
-
-	bliss::Stats stats;
-	const unsigned int *cl = g.canonical_form(stats, NULL, NULL);
-	cout << "==>cl=" << *cl << endl;
-	bliss::Digraph *cf = g.permute(cl);
-	FILE *fp2 = fopen("f2", "w");
-	cf->write_dimacs(fp2);
-	fclose(fp2);
-	if (cf->cmp(g) == 0){
-		return (true);
-	} else{
-		return (false);
-	}
-}
-
-
 int matchesPattern(Candidates& candidates, CandidateInfo& candidateInfo,
-		const vector<pair<set<int>, int> >& label,
-		const vector<vector<NodeInfo> >& listNodes) {
+		const vector<pair<ItemSet, int> >& label,
+		const Dataset& listNodes) {
 	const vector<SequenceInfo>* values = candidates.getSequencesInfo(candidateInfo);
 
 	for (vector<SequenceInfo>::const_iterator sii = values->begin();
 			sii != values->end(); sii++) {
 		if (sii->getNbTree() < patternsCount) {
-			if (listNodes[sii->getNbTree()].size() == label.size()){
+			if (listNodes[sii->getNbTree()].size() == (int) label.size()){
 				bool found = true;
 				for (int i = 0 ; i < (int)label.size() ; i++) {
-					if (label[i].first != listNodes[sii->getNbTree()][i].labels){
+					const Dataset::Range labels = listNodes[sii->getNbTree()][i].labels;
+					if ((label[i].first.size() != labels.size())
+							|| !std::equal(labels.begin(), labels.end(), label[i].first.begin())){
 						found = false;
 						break;
 					}
@@ -924,9 +1074,8 @@ int matchesPattern(Candidates& candidates, CandidateInfo& candidateInfo,
 	return (-1);
 }
 
-bool containsPattern(Candidates& candidates,
-		const vector<pair<set<int>, int> >& label) {
-	const vector<SequenceInfo>* values = &candidates.candidates[label].subtrees;
+bool containsPattern(Candidates& candidates, const int patternId) {
+	const vector<SequenceInfo>* values = &candidates.candidates[patternId].subtrees;
 
 	for (vector<SequenceInfo>::const_iterator sii = values->begin();
 			sii != values->end(); sii++) {
@@ -937,45 +1086,88 @@ bool containsPattern(Candidates& candidates,
 	return (false);
 }
 
-int countMotifs(const vector<SequenceInfo>* values) {
-	int count = 0;
-	if (countUnique) {
-		// one occurence per tree
-		set<int> differentTrees;
-		for (vector<SequenceInfo>::const_iterator sii = values->begin();
-				sii != values->end(); sii++) {
-			if ((*sii).getNbTree() >= patternsCount) {
-				differentTrees.insert((*sii).getNbTree());
+/**
+ * Computes the minimum image support of a candidate (method of Njissen): the
+ * lowest number of distinct nodes matched by a node of the pattern.
+ * The (tree, node) pairs matched by each node of the pattern are packed in
+ * 64-bit keys, then sorted and deduplicated. The count stops as soon as a node
+ * of the pattern matches fewer than threshold pairs: the result is then only
+ * known to be lower than threshold.
+ * When stopAtThreshold is set, the embeddings are processed by batches of
+ * increasing size, and the count also stops when every node of the pattern
+ * matches threshold pairs: the result is then only known to reach threshold.
+ * @param values the embeddings of the candidate
+ * @param embeddings the store of the embeddings
+ * @param threshold the min support
+ * @param stopAtThreshold a flag that indicates if the count stops when the min support is reached
+ */
+int countMinimumImages(const vector<SequenceInfo>& values, const EmbeddingStore& embeddings,
+		const int threshold, const bool stopAtThreshold) {
+	// the keys of each node of the pattern, sorted and unique up to sortedSizes
+	vector<vector<uint64_t> > keys;
+	vector<int> sortedSizes;
+	vector<int> path;
+	int next = 0;
+	while (next < (int) values.size()) {
+		int end = values.size();
+		if (stopAtThreshold) {
+			end = min(end, max(2 * next, max(threshold, 64)));
+		}
+		for (int e = next; e < end; e++) {
+			const SequenceInfo& si = values[e];
+			if (si.getNbTree() >= patternsCount) {
+				embeddings.getPath(si.getEmbedding(), path);
+				if (keys.empty()) {
+					keys.resize(path.size());
+					sortedSizes.resize(path.size(), 0);
+				}
+				for (int i = 0; i < (int) path.size(); i++) {
+					keys[i].push_back((((uint64_t) si.getNbTree()) << 32) | (uint32_t) path[i]);
+				}
 			}
 		}
-		count = (int) differentTrees.size();
-	} else {
-		count = INT_MAX;
-		// method of Njissen
-		vector<set<pair<int,int> > > differentNodes (values->at(0).getSize());
-		for (vector<SequenceInfo>::const_iterator sii = values->begin();
-				sii != values->end(); sii++) {
-			if ((*sii).getNbTree() >= patternsCount){
-				for (int i = 0 ; i < sii->getSize() ; i++){
-					differentNodes[i].insert(pair<int,int>(sii->getNbTree(),sii->getElementAt(i)));
-				}
+		next = end;
+		int count = INT_MAX;
+		for (int i = 0; i < (int) keys.size(); i++) {
+			vector<uint64_t>& k = keys[i];
+			std::sort(k.begin() + sortedSizes[i], k.end());
+			std::inplace_merge(k.begin(), k.begin() + sortedSizes[i], k.end());
+			k.erase(std::unique(k.begin(), k.end()), k.end());
+			sortedSizes[i] = k.size();
+			count = min(count, (int) k.size());
+			if ((next == (int) values.size()) && (count < threshold)) {
+				return (count);
 			}
 		}
-		for (vector<set<pair<int,int> > >::iterator it = differentNodes.begin() ; it != differentNodes.end() ; it++){
-			count = min(count, (int)it->size());
+		if (keys.empty()) {
+			continue;
+		}
+		if ((next == (int) values.size()) || (count >= threshold)) {
+			return (count);
 		}
 	}
+	return (0);
+}
+
+int countMotifs(const CandidateInfo& candidateInfo, const EmbeddingStore& embeddings) {
+	int count = 0;
+	if (countUnique) {
+		// one occurence per tree
+		count = candidateInfo.trees.count(patternsCount);
+	} else {
+		count = countMinimumImages(candidateInfo.subtrees, embeddings,
+				absoluteSupport, stopCountAtSupport);
+	}
 	return (count);
 }
 
-int countMotifsByLabel(Candidates& candidates,
-		const vector<pair<set<int>, int> >& label) {
-	return (countMotifs(&candidates.newCandidates[label].subtrees));
+int countMotifsByLabel(Candidates& candidates, const int patternId) {
+	return (countMotifs(candidates.newCandidates[patternId], candidates.embeddings));
 }
 
 
-bool isSubSequence(const vector<pair<set<int>, int> >& lhs,
-		const vector<pair<set<int>, int> >& rhs) {
+bool isSubSequence(const vector<pair<ItemSet, int> >& lhs,
+		const vector<pair<ItemSet, int> >& rhs) {
 	if (lhs == rhs)
 		return (false);
 	if (lhs.size() != rhs.size())
@@ -1000,24 +1192,13 @@ int getNbOccurences(const vector<SequenceInfo>* values) {
 	return (occur);
 }
 
-int getNbOccurencesByLabel(Candidates& candidates,
-		const vector<pair<set<int>, int> >& label) {
-	return (getNbOccurences(&candidates.newCandidates[label].subtrees));
+int getNbOccurencesByLabel(Candidates& candidates, const int patternId) {
+	return (getNbOccurences(&candidates.newCandidates[patternId].subtrees));
 }
 
 pair<int, int> getInheritedCount(Candidates& candidates,
-		const vector<pair<set<int>, int> >& label) {
-	pair<int, int> count;
-	for (map<vector<pair<set<int>, int> >, CandidateInfo >::const_iterator it =
-			candidates.candidates.begin()/*upper_bound(label)*/;
-			it != candidates.candidates.end(); it++) {
-//		vector<pair<set<int>, int> > l2 = (it->first);
-		if (isSubSequence(label, it->first)) {
-			count.first = max(count.first, it->second.perTreeFrequency);
-			count.second = max(count.second, it->second.nbOccurences);
-		}
-	}
-	return (count);
+		const vector<pair<ItemSet, int> >& label) {
+	return (candidates.closureIndex.getInheritedCount(candidates.patterns, label));
 }
 
 /*
@@ -1025,35 +1206,22 @@ pair<int, int> getInheritedCount(Candidates& candidates,
  * if a substructure of label is found, then, mark it as nonClosed
  */
 void markPreviousNonClosedCandidates(Candidates& candidates,
-		const vector<pair<set<int>, int> >& label, int freq) {
+		const vector<pair<ItemSet, int> >& label, int freq) {
 	if (label.size() == 1) {
 		return;
 	}
 
+	vector<pair<ItemSet, int> > l;
 	for (int i = 0; i < (int) label.size(); i++) {
-		vector<pair<set<int>, int> > l = label;
-		int depth = (l.begin() + i)->second;
-		l.erase(l.begin() + i);
-		for (int j = i; j < (int) l.size(); j++) {
-			if ((l.begin() + j)->second > depth) {
-				(l.begin() + j)->second -= 1;
-			} else {
-				break;
-			}
-		}
-		for (map<vector<pair<set<int>, int> >, CandidateInfo >::iterator it =
-				candidates.candidates.begin()/*upper_bound(label)*/;
-				it != candidates.candidates.end(); it++) {
-			if ((l == it->first)) { // || isSubSequence(it->first, l)) {
-
-				if (it->second.perTreeFrequency == freq) {
-					if (verbose)
-						cout << "removing closed " << serialize(it->first)
-								<< endl;
-					candidates.setClosed(&it->second);
-				}
-//				count.first = max(count.first, it->second.first);
-//				count.second = max(count.second, it->second.second);
+		StructuralClosureIndex::deleteNode(label, i, l);
+		unordered_map<int, CandidateInfo >::iterator it =
+				candidates.candidates.find(candidates.patterns.find(l));
+		if (it != candidates.candidates.end()) {
+			if (it->second.perTreeFrequency == freq) {
+				if (verbose)
+					cout << "removing closed " << serialize(l)
+							<< endl;
+				candidates.setClosed(&it->second);
 			}
 		}
 	}
@@ -1064,37 +1232,13 @@ void markPreviousNonClosedCandidates(Candidates& candidates,
  * for patterns including label
  */
 pair<int, int> getInheritedCountStructural(const Candidates& candidates,
-		const vector<pair<set<int>, int> >& label) {
-	pair<int, int> count;
-	for (map<vector<pair<set<int>, int> >, CandidateInfo >::const_iterator it =
-			candidates.candidates.begin()/*upper_bound(label)*/;
-			it != candidates.candidates.end(); it++) {
-		if (it->first.size() == 1) {
-			continue;
-		}
-		for (int i = 0; i < (int) it->first.size(); i++) {
-			vector<pair<set<int>, int> > l = it->first;
-			int depth = (l.begin() + i)->second;
-			l.erase(l.begin() + i);
-			for (int j = i; j < (int) l.size(); j++) {
-				if ((l.begin() + j)->second > depth) {
-					(l.begin() + j)->second -= 1;
-				} else {
-					break;
-				}
-			}
-			if ((label == l)) { // || isSubSequence(label, l)) {
-				count.first = max(count.first, it->second.perTreeFrequency);
-				count.second = max(count.second, it->second.nbOccurences);
-			}
-		}
-	}
-	return (count);
+		const vector<pair<ItemSet, int> >& label) {
+	return (candidates.structuralIndex.getInheritedCount(candidates.patterns, label));
 }
 
 void filterNewCandidates(Candidates& candidates){
 	if (patternSearch) {
-		for (map<vector<pair<set<int>, int> >, CandidateInfo >::iterator candIt = candidates.newCandidates.begin(); candIt != candidates.newCandidates.end() ; candIt++){
+		for (unordered_map<int, CandidateInfo >::iterator candIt = candidates.newCandidates.begin(); candIt != candidates.newCandidates.end() ; ){
 			bool containsPattern = false;
 			for (vector<SequenceInfo>::const_iterator sii = candIt->second.subtrees.begin();
 					sii != candIt->second.subtrees.end(); sii++) {
@@ -1105,7 +1249,8 @@ void filterNewCandidates(Candidates& candidates){
 			}
 
 			if (!containsPattern) {
-				candidates.newCandidates.erase(candIt++);
+				unordered_map<int, CandidateInfo >::iterator current = candIt++;
+				candidates.eraseNewCandidate(current);
 			} else {
 				++candIt;
 			}
@@ -1116,23 +1261,35 @@ void filterNewCandidates(Candidates& candidates){
 		return;
 	}
 
-	for (map<vector<pair<set<int>, int> >, CandidateInfo >::iterator candIt =
+	vector<pair<ItemSet, int> > label;
+	for (unordered_map<int, CandidateInfo >::iterator candIt =
 			candidates.newCandidates.begin();
 			candIt != candidates.newCandidates.end(); ) {
 		bool shouldDelete = false;
-		if (!orderedSearch && (isCanonical(candIt->first) ==1)) {
-			shouldDelete = true;
+		if (!orderedSearch) {
+			CandidateInfo& candidateInfo = candIt->second;
+			if (candidateInfo.canonicalForm == CandidateInfo::UNKNOWN_FORM) {
+				candidates.getLabel(candIt->first, label);
+				candidateInfo.canonicalForm = isCanonical(label);
+			}
+			if (candidateInfo.canonicalForm ==1) {
+				shouldDelete = true;
+			}
 		}
 
 		if (!shouldDelete){
-			int count = countMotifs(&(candIt->second.subtrees));
+			int count = countMotifs(candIt->second, candidates.embeddings);
 			if (count < absoluteSupport) {
 				shouldDelete = true;
+			} else {
+				// the count is reused when the candidate is extended
+				candIt->second.support = count;
 			}
 		}
 
 		if (shouldDelete) {
-			candidates.newCandidates.erase(candIt++);
+			unordered_map<int, CandidateInfo >::iterator current = candIt++;
+			candidates.eraseNewCandidate(current);
 		} else {
 			++candIt;
 		}
@@ -1140,300 +1297,119 @@ void filterNewCandidates(Candidates& candidates){
 	candidates.storeNewCandidates();
 }
 
+enum {UNKNOWN_LABEL, CANONICAL_LABEL, NON_CANONICAL_LABEL};
+
 /**
- * Generates a new list of candidates from a previous one by appending individual nodes.
- * @param candidates a list of candidates
- * @param listNodes a list of nodes
+ * Returns the status of a label in a table indexed by labels.
+ * The table is allocated on first use.
+ * @param table a table of status
+ * @param label a label
  */
-void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo> >& listNodes) {
-	pair<vector<pair<set<int>, int> >, CandidateInfo* >* candi = &candidates.currentCandidates.back();
-	const vector<pair<set<int>, int> >* label = &candi->first;
-	CandidateInfo* candidateInfo = candi->second;
-	vector<SequenceInfo>* values = &(candi->second->subtrees);
+char& getLabelStatus(vector<char>& table, const int label) {
+	if (table.empty()) {
+		table.resize(nbLabels, UNKNOWN_LABEL);
+	}
+	return (table[label]);
+}
 
-		if (patternSearch) {
-			if (!containsPattern(candidates, *label)) {
-				candidates.removeCandidate(false);
-				return;
-			}
-		}
-
-	int count = countMotifs(values);
-	int nbOfOccurences = getNbOccurences(values);
-	bool iscanonical1 = (isCanonical(*label) == -1);
-
-	if (count < absoluteSupport) {
-		candidates.removeCandidate(false);
-		return;
-	}
-
-	int canonical = isCanonical(*label);
-	int canonicalCycle = -1;
-	if ((canonical != 1) && *(label->back().first.begin()) == -1){
-		// test the canonicity of a pattern with cycle
-		canonicalCycle = isCycleCanonical(*label);
-	}
-
-	if (!orderedSearch && ((canonical == 1) || (canonicalCycle ==1))) {
-		candidates.removeCandidate(false);
-		return;
-	}
-
-	bool extensionOfLastNodeAllowed = true;
-	if (!orderedSearch && (canonical == 0)) {
-		extensionOfLastNodeAllowed = false;
-		int option = 2;
-		if (option ==1){
-			//only sibblings can be added to this pattern
-			// we can keep only one occurence of path with the same right hand path
-			vector<int> rightPathElts;
-			int rightPathElt = label->size()-1;
-			while (rightPathElt != -1) {
-				rightPathElts.insert(rightPathElts.begin(),rightPathElt);
-				rightPathElt = getParent(*label, rightPathElt);
-			}
-
-			set<pair<int,vector<int> > > pathsToRemove;
-			vector<SequenceInfo> newValue;
-			for (vector<SequenceInfo>::iterator it = values->begin();
-					it != values->end();it++) {
-				vector<int> rightPathContent;
-				for (uint i = 0 ; i < rightPathElts.size() ; i++){
-					rightPathContent.push_back(it->pathList[i]);
-				}
-				pair<int,vector<int> > elt = pair<int,vector<int> >(it->getNbTree(), rightPathContent);
-				if (pathsToRemove.count(elt) > 0){
-				} else{
-					pathsToRemove.insert(elt);
-					newValue.push_back(*it);
-				}
-			}
-			values->clear();
-			values->insert(values->end(),newValue.begin(),newValue.end());
-		}
-		else if (option ==2){
-			set<set<int> > pathElts;
-			vector<SequenceInfo> newValue;
-			for (vector<SequenceInfo>::iterator it = values->begin();
-					it != values->end();it++) {
-				set<int> p;
-				p.insert(it->pathList.begin(),it->pathList.end());
-
-				if (pathElts.count(p) > 0){
-				} else{
-					pathElts.insert(p);
-					newValue.push_back(*it);
-				}
-			}
-			if (verbose) cout << "reduction of instances (automorph)" << values->size() << " to " << newValue.size() << endl;
-			values->clear();
-			values->insert(values->end(),newValue.begin(),newValue.end());
-		}
-	}
-	bool newOptimisation = true;
-	if (newOptimisation){
-		if ((label->back().second == 1) && (label->back().first.size() ==1)){
-			const int pos = label->size()-1;
-			int posOfPreviousSibling = getPreviousSibbling(*label, label->size()-1);
-			if ((posOfPreviousSibling != -1) && (*((*label)[posOfPreviousSibling].first.begin()) < *(label->back().first.begin()))){
-				set<set<int> > pathElts;
-				set<int> lastElt;
-				vector<SequenceInfo> newValue;
-				for (vector<SequenceInfo>::iterator it = values->begin();
-						it != values->end();it++) {
-					set<int> p;
-					p.insert(it->pathList.begin(),it->pathList.end()-1);
-
-					if ((pathElts.count(p) > 0)&&(lastElt.count(it->pathList.back())>0)){
-					} else{
-						pathElts.insert(p);
-						lastElt.insert(it->pathList.back());
-						newValue.push_back(*it);
-					}
-				}
-				if (verbose) cout << "reduction of instances(opt1)" << values->size() << " to " << newValue.size() << endl;
-				values->clear();
-				values->insert(values->begin(),newValue.begin(),newValue.end());
-			}
-		}
-	}
-
-	bool newOptimisation2 = true;
-	if (newOptimisation2){
-		vector<int> rightPathElts;
-		int rightPathElt = label->size()-1;
-		while (rightPathElt != -1) {
-			rightPathElts.insert(rightPathElts.begin(),rightPathElt);
-			rightPathElt = getParent(*label, rightPathElt);
-		}
-		for (uint i = 1 ; i < rightPathElts.size()-1 ; i++){
-			vector<pair<set<int>, int> > labelFromParent;
-			labelFromParent.insert(labelFromParent.begin(), label->begin()+rightPathElts[i], label->end());
-			bool good = true;
-			for (vector<pair<set<int>, int> >::iterator it = labelFromParent.begin() ; it < labelFromParent.end() ; it++){
-				if (*(it->first.begin()) < 0){
-					good = false;
-					break;
-				}
-			}
-			if (good && isCanonical(labelFromParent) ==0 ){
-				set<pair<vector<int>,set<int> > > pathElts;
-				vector<SequenceInfo> newValue;
-				for (vector<SequenceInfo>::iterator it = values->begin();
-						it != values->end();it++) {
-					set<int> s;
-					s.insert(it->pathList.begin()+rightPathElts[i],it->pathList.end());
-					vector<int> v;
-					v.insert(v.begin(),it->pathList.begin(),it->pathList.begin()+rightPathElts[i]);
-					pair<vector<int>,set<int> > p (v,s);
-					if (pathElts.count(p) > 0){
-					} else{
-						pathElts.insert(p);
-						newValue.push_back(*it);
-					}
-				}
-				if (verbose)cout << "reduction of instances(opt2)" << values->size() << " to " << newValue.size() << endl;
-
-				values->clear();
-				values->insert(values->end(),newValue.begin(),newValue.end());
-				break;
-
-			}
-
-		}
-	}
-	bool closedCandidate = false;
-	if (closedItemsetSearch && itemSetMining) {
-		pair<int, int> inheritedCount = getInheritedCount(candidates, *label);
-
-		if (inheritedCount.first > 0
-				&& inheritedCount.second == nbOfOccurences) {
-			if (!closedCandidate && closedSequenceSearch) {
-				candidates.setSuperCount(candidateInfo, count, nbOfOccurences);
-			}
-			if (closedSequenceSearch) {
-				candidates.setClosed(candidateInfo);
-			}
-			candidates.removeCandidate(closedItemsetSearch || closedSequenceSearch);
-			return;
-		}
-		if (inheritedCount.first >= count) {
-			closedCandidate = true;
-		}
-	}
-
-	if (itemSetMining && extensionOfLastNodeAllowed) {
-		map<int, vector<SequenceInfo>* > memoLp;
-
-		set<vector<pair<set<int>, int> > > superSequences;
-		for (vector<SequenceInfo>::const_iterator c = values->begin();
-				c != values->end(); c++) {
-			int n = (*c).getLast();
-			const NodeInfo* nodeId = &listNodes[(*c).getNbTree()][n];
+enum {UNKNOWN_BOUND, REACHABLE_BOUND, UNREACHABLE_BOUND};
 
-			// add an item to the itemset of the last node
-			const set<int>& currentLabel = label->back().first;
-			if (nodeId->labels.size() > 1) {
-				for (set<int>::const_iterator labelIt = nodeId->labels.begin();
-						labelIt != nodeId->labels.end(); labelIt++) {
-					if ((*labelIt) > (*currentLabel.rbegin())) {
-						vector<SequenceInfo>* pvsi;
-						if (memoLp.count(*labelIt) > 0) {
-							pvsi = memoLp[*labelIt];
-						} else {
-							vector<pair<set<int>, int> > labelPath = *label;
-							(labelPath.rbegin())->first.insert(*labelIt);
-							if (closedItemsetSearch) {
-								superSequences.insert(labelPath);
-							}
-							pvsi = &candidates.newCandidates[labelPath].subtrees;
-							memoLp[*labelIt] = pvsi;
-							if (verbose){
-								cout <<"generated pattern : " << serialize(labelPath) << endl;
-							}
-						}
-						vector<int> path = (*c).getPathList();
-						SequenceInfo si = SequenceInfo((*c).getNbTree(), path);
-						pvsi->push_back(si);
-					}
-				}
-			}
-		}
-
-		if (closedItemsetSearch) {
-			bool identicalSuperset = false;
-
-			for (set<vector<pair<set<int>, int> > >::const_iterator supIt =
-					superSequences.begin(); supIt != superSequences.end();
-					supIt++) {
-
-				if (getNbOccurencesByLabel(candidates, *supIt) == nbOfOccurences) {
-					identicalSuperset = true;
-				}
-				if (countMotifsByLabel(candidates, *supIt) == count) {
-					closedCandidate = true;
-
-					if (closedSequenceSearch) {
-						candidates.setClosed(candidateInfo);
-						candidates.setSuperCount(candidateInfo, count, nbOfOccurences);
-					}
-				}
-			}
-
-			// if a candidates, created by adding a new item to the last itemset
-			// has the same occurence of the current pattern, then, the extension of
-			// the current pattern is not needed
-			// in addition, the current pattern is redundant
-			if (identicalSuperset) {
-				candidates.removeNewCandidate(*label);
-				if (closedSequenceSearch) {
-					candidates.setClosed(candidateInfo);
-					candidates.setSuperCount(candidateInfo, count, nbOfOccurences);
-				}
-
-				return;
-			}
+/**
+ * Tests if the patterns obtained by adding a node with a given label to a
+ * candidate can be frequent: the label must occur in enough trees of the
+ * candidate. The bound is only valid when occurrences are counted once per tree.
+ * When the patterns are recorded, all the extensions that occur are searched,
+ * so that their supports are known when trees are appended.
+ * @param table the result of the test for each label
+ * @param trees the trees of the candidate
+ * @param label the label of the new node
+ */
+bool canBeFrequent(vector<char>& table, const TreeBitmap& trees, const int label) {
+	char& bound = getLabelStatus(table, label);
+	if (bound == UNKNOWN_BOUND) {
+		int support = (recordPatterns ? 1 : absoluteSupport.load());
+		if (trees.countCommon(labelTrees[label], patternsCount) >= support) {
+			bound = REACHABLE_BOUND;
+		} else {
+			bound = UNREACHABLE_BOUND;
 		}
 	}
+	return (bound == REACHABLE_BOUND);
+}
 
-	if (!closedCandidate && closedSequenceSearch) {
-		markPreviousNonClosedCandidates(candidates, *label, count);
-		pair<int, int> inheritedCount = getInheritedCountStructural(candidates, *label);
-
-		if (inheritedCount.first >= count) {
-			closedCandidate = true;
-			if (verbose)
-				cout << "closed: " << serialize(*label) << endl;
-		}
-
-	}
-	if (closedItemsetSearch || closedSequenceSearch) {
-		candidates.setSuperCount(candidateInfo, count, nbOfOccurences);
-		if (closedCandidate && closedSequenceSearch) {
-			candidates.setClosed(candidateInfo);
-		}
-	}
+/* shared state of the parallel search */
+mutex taskMutex;
+condition_variable taskAvailable;
+deque<MiningTask> sharedTasks;
+int idleWorkers = 0;
+atomic<int> hungryWorkers(0);
+// minimum number of embeddings extended by a thread
+const int minEmbeddingsPerThread = 4096;
 
-	if (outputFrequentTrees && !closedCandidate && !closedSequenceSearch) {
-		if (!patternSearch) {
-			writeSolution(candidates, *label, count);
-		} else {
-			int basePattern = matchesPattern(candidates, *candidateInfo, *label, listNodes);
-			if (basePattern != -1) {
-				writeSolutionForSearchPattern(candidates, *label, count, basePattern);
-			}
+/**
+ * Borrows the threads of hungry workers to extend a large candidate.
+ * @param wanted the number of threads needed
+ * @return the number of threads obtained
+ */
+int reserveHelpers(int wanted) {
+	int available = hungryWorkers;
+	while ((available > 0) && (wanted > 0)) {
+		int n = min(available, wanted);
+		if (hungryWorkers.compare_exchange_weak(available, available - n)) {
+			return (n);
 		}
 	}
+	return (0);
+}
 
-	map<pair<int, int>, vector<SequenceInfo>* > memoLp;
-	map<int, set<int> > labelsGeneratingNonCanonicalPatterns;
-	map<int, set<int> > labelsGeneratingCanonicalPatterns;
+/**
+ * Gives back threads obtained with reserveHelpers.
+ * @param nbHelpers the number of threads
+ */
+void releaseHelpers(int nbHelpers) {
+	hungryWorkers += nbHelpers;
+}
 
-	for (vector<SequenceInfo>::const_iterator c = values->begin();
-			c != values->end(); c++) {
+/**
+ * Generates the candidates obtained by adding a node to a range of embeddings of
+ * a candidate. Only the buffer is modified, so that several ranges can be
+ * processed concurrently.
+ * @param candidates a list of candidates
+ * @param nodes a list of nodes
+ * @param label the sequence of nodes of the candidate
+ * @param canonicalState the state of the canonical form test of the candidate
+ * @param trees the trees of the candidate
+ * @param extensionOfLastNodeAllowed a flag that indicates if children can be added to the last node
+ * @param first the first embedding of the range
+ * @param last the end of the range
+ * @param buffer the generated candidates
+ */
+void extendEmbeddings(const Candidates* candidates, const Dataset* nodes,
+		const vector<pair<ItemSet, int> >* label, const CanonicalState* canonicalState,
+		const TreeBitmap* trees, bool extensionOfLastNodeAllowed,
+		vector<SequenceInfo>::const_iterator first,
+		vector<SequenceInfo>::const_iterator last,
+		ExtensionBuffer* buffer) {
+	const Dataset& listNodes = *nodes;
+	ExtensionBuffer& extensions = *buffer;
+	map<pair<int, int>, int> memoLp;
+	// canonicity of the patterns generated by adding a label under a node
+	// of the rightmost path (index 0 for the last node)
+	vector<vector<char> > labelStatus(label->size() + 1);
+	// labels that can give frequent patterns, whatever the position of the new node
+	vector<char> labelBounds;
+	// the label with reentrant nodes replaced, to update the canonical form test
+	vector<pair<ItemSet, int> > replacedLabel;
+	if (!orderedSearch) {
+		CanonicalState::replaceReentrantNodes(*label, replacedLabel);
+	}
+
+	vector<int> pl;
+	for (vector<SequenceInfo>::const_iterator c = first;
+			c != last; c++) {
 		bool canAddDescendant = true;
 		int n = (*c).getLast();
-		vector<int> pl = (*c).getPathList();
+		candidates->embeddings.getPath((*c).getEmbedding(), pl);
 		set<int> eltSet(pl.begin(), pl.end()-1);
 
 		if (eltSet.count(n) != 0){
@@ -1444,44 +1420,44 @@ void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo>
 		if (undirectedGraph){
 			// code to mine undirected graphs
 			// find ancestor
-			if ((*c).getSize() >= 2){
-				int parentPos = (*c).getSize() - 2; // the last node of the path cannot be a parent
-				int lastChildPos = (*c).getSize() - 1;
+			if (pl.size() >= 2){
+				int parentPos = pl.size() - 2; // the last node of the path cannot be a parent
+				int lastChildPos = pl.size() - 1;
 
-				while (!isAncestor(listNodes[(*c).getNbTree()], (*c).getElementAt(parentPos),
-						(*c).getElementAt(lastChildPos),maximumGap)) {
+				while (!isAncestor(listNodes[(*c).getNbTree()], pl[parentPos],
+						pl[lastChildPos],maximumGap)) {
 					parentPos -= 1;
 				}
-				excludedNodes.insert((*c).getElementAt(parentPos)); // to avoid going back to parent
+				excludedNodes.insert(pl[parentPos]); // to avoid going back to parent
 			}
 		}
 
-		if (extensionOfLastNodeAllowed && canAddDescendant && ((maxDepth == -1) || ((int)(*c).getSize() < maxDepth))){
+		if (extensionOfLastNodeAllowed && canAddDescendant && ((maxDepth == -1) || ((int)pl.size() < maxDepth))){
 			// add a descendant to the last node
 
-			set<int>::iterator start = listNodes[(*c).getNbTree()][n].childNodes.begin();
-			set<int>::iterator end = listNodes[(*c).getNbTree()][n].childNodes.end();
-			set<int> childNodes;
+			Dataset::Range::const_iterator start = listNodes[(*c).getNbTree()][n].childNodes.begin();
+			Dataset::Range::const_iterator end = listNodes[(*c).getNbTree()][n].childNodes.end();
+			vector<int> childNodes;
 			if (maximumGap != 0){
 				collectAllChilds(listNodes[(*c).getNbTree()], n, maximumGap, childNodes);
-				start = childNodes.begin();
-				end = childNodes.end();
+				start = childNodes.data();
+				end = childNodes.data() + childNodes.size();
 			}
 
-			for (set<int>::iterator it = start ; it != end; it++){
+			for (Dataset::Range::const_iterator it = start ; it != end; it++){
 				if (excludedNodes.count(*it) > 0){
 					continue;
 				}
 
-				const NodeInfo* nodeIdi = &listNodes[(*c).getNbTree()][*it];
-				if (!(nodeIdi->isFrequent())) {
+				const Dataset::Node nodeIdi = listNodes[(*c).getNbTree()][*it];
+				if (!(nodeIdi.isFrequent())) {
 					continue;
 				}
 				const int depth = label->back().second + 1;
 
 				int reentrantNodeIndex = -1;
-				for (uint i = 0 ; i < (*c).getPathList().size() ; i++){
-					if ((*c).getPathList()[i] == *it){
+				for (uint i = 0 ; i < pl.size() ; i++){
+					if (pl[i] == *it){
 						reentrantNodeIndex = i;
 						break;
 					}
@@ -1489,90 +1465,98 @@ void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo>
 				if (reentrantNodeIndex != -1){
 					// try to add an edge to an existing node
 					int reentrantCode = -(reentrantNodeIndex+1);
-					vector<SequenceInfo>* pvsi;
+					int newCandidate;
 					if (memoLp.count(pair<int, int>(reentrantCode, depth)) > 0) {
-						pvsi = memoLp[pair<int, int>(reentrantCode, depth)];
+						newCandidate = memoLp[pair<int, int>(reentrantCode, depth)];
 					} else {
-						vector<pair<set<int>, int> > labelPath;
-						labelPath = *label;
-						set<int> labelSet;
+						ItemSet labelSet;
 						labelSet.insert(reentrantCode);
 						labelSet.insert(999);
+						pair<ItemSet, int> newNode(labelSet, depth);
 
-						labelPath.push_back(pair<set<int>, int>(labelSet, depth));
-
-						pvsi = &candidates.newCandidates[labelPath].subtrees;
-						memoLp[pair<int, int>(reentrantCode, depth)] = pvsi;
+						CanonicalState state;
+						if (!orderedSearch) {
+							state = *canonicalState;
+							state.append(replacedLabel,
+									pair<ItemSet, int>(replacedLabel[reentrantNodeIndex].first, depth));
+						}
+						newCandidate = extensions.addCandidate(newNode, state);
+						memoLp[pair<int, int>(reentrantCode, depth)] = newCandidate;
 						if (verbose){
-							cout <<"generated pattern : " << serialize(labelPath) << endl;
+							vector<pair<ItemSet, int> > labelPath = *label;
+							labelPath.push_back(newNode);
+							writeOutput("generated pattern : " + serialize(labelPath) + "\n");
 						}
 					}
-					vector<int> path = (*c).getPathList();
-					path.push_back(*it);
-					SequenceInfo si = SequenceInfo((*c).getNbTree(), path);
-					pvsi->push_back(si);
+					SequenceInfo si = SequenceInfo((*c).getNbTree(),
+							extensions.embeddings.add((*c).getEmbedding(), *it), *it);
+					extensions.addSubtree(newCandidate, si);
 					continue;
 				}
 
-				for (set<int>::const_iterator labelIt =
-						listNodes[(*c).getNbTree()][*it].labels.begin();
-						labelIt != listNodes[(*c).getNbTree()][*it].labels.end();
+				for (Dataset::Range::const_iterator labelIt =
+						nodeIdi.labels.begin();
+						labelIt != nodeIdi.labels.end();
 						labelIt++) {
-					if (!orderedSearch && labelsGeneratingNonCanonicalPatterns[-1].count(*labelIt)> 0){
+					if (!orderedSearch && getLabelStatus(labelStatus[0], *labelIt) == NON_CANONICAL_LABEL){
 						continue; // there is no need to add this label
 					}
-					vector<SequenceInfo>* pvsi;
+					if (countUnique && !canBeFrequent(labelBounds, *trees, *labelIt)) {
+						continue;
+					}
+					int newCandidate;
 					if (memoLp.count(pair<int, int>(*labelIt, depth)) > 0) {
-						pvsi = memoLp[pair<int, int>(*labelIt, depth)];
+						newCandidate = memoLp[pair<int, int>(*labelIt, depth)];
 					} else {
-						vector<pair<set<int>, int> > labelPath;
+						vector<pair<ItemSet, int> > labelPath;
 						labelPath = *label;
-						set<int> labelSet;
+						ItemSet labelSet;
 						labelSet.insert(*labelIt);
 
-						labelPath.push_back(pair<set<int>, int>(labelSet, depth));
+						labelPath.push_back(pair<ItemSet, int>(labelSet, depth));
+						CanonicalState state;
 						if (!orderedSearch){
 
-							if (labelsGeneratingCanonicalPatterns[-1].count(*labelIt) == 0){
-								if (isCanonical(labelPath) != 1) {
-									labelsGeneratingCanonicalPatterns[-1].insert(*labelIt);
+							if (getLabelStatus(labelStatus[0], *labelIt) == UNKNOWN_LABEL){
+								state = *canonicalState;
+								state.append(replacedLabel, labelPath.back());
+								if (state.getForm() != 1) {
+									getLabelStatus(labelStatus[0], *labelIt) = CANONICAL_LABEL;
 								} else{
-									labelsGeneratingNonCanonicalPatterns[-1].insert(*labelIt);
+									getLabelStatus(labelStatus[0], *labelIt) = NON_CANONICAL_LABEL;
 									continue;
 								}
 							}
 						}
 
-						pvsi = &candidates.newCandidates[labelPath].subtrees;
-						memoLp[pair<int, int>(*labelIt, depth)] = pvsi;
+						newCandidate = extensions.addCandidate(labelPath.back(), state);
+						memoLp[pair<int, int>(*labelIt, depth)] = newCandidate;
 						if (verbose){
-							cout <<"generated pattern : " << serialize(labelPath) << endl;
+							writeOutput("generated pattern : " + serialize(labelPath) + "\n");
 						}
 
 					}
-					vector<int> path = (*c).getPathList();
-					path.push_back(*it);
-					SequenceInfo si = SequenceInfo((*c).getNbTree(), path);
-					pvsi->push_back(si);
+					SequenceInfo si = SequenceInfo((*c).getNbTree(),
+							extensions.embeddings.add((*c).getEmbedding(), *it), *it);
+					extensions.addSubtree(newCandidate, si);
 				}
 			}
 		}
 
-		if ((*c).getSize() < 2)
+		if (pl.size() < 2)
 			continue;
 		if (sequenceSearch) continue;
 		// add sibblings at any level of the path
 
-		int parentPos = (*c).getSize() - 2; // the last node of the path cannot be a parent
+		int parentPos = pl.size() - 2; // the last node of the path cannot be a parent
 		int parentDepth = (*label)[parentPos].second;
-		int lastChildPos = (*c).getSize() - 1;
+		int lastChildPos = pl.size() - 1;
 		excludedNodes.clear();
 		while (parentPos >= 0) {
-			excludedNodes.insert((*c).getElementAt(lastChildPos));
+			excludedNodes.insert(pl.at(lastChildPos));
 
-			vector<int> pl = (*c).getPathList();
 			set<int> eltSet(pl.begin(), pl.end());
-			int n = (*c).getElementAt(parentPos);
+			int n = pl.at(parentPos);
 			if (eltSet.count(n) != 1){
 				continue;
 			}
@@ -1580,47 +1564,47 @@ void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo>
 
 			// TODO not good for embedded DAGs
 			if (maximumGap != 0){
-				collectAllChilds(listNodes[(*c).getNbTree()], (*c).getElementAt(parentPos+1), maximumGap+1, excludedNodes);
+				collectAllChilds(listNodes[(*c).getNbTree()], pl.at(parentPos+1), maximumGap+1, excludedNodes);
 			}else{
-				excludedNodes.insert((*c).getElementAt(parentPos+1));
+				excludedNodes.insert(pl.at(parentPos+1));
 			}
 			if ((*label)[parentPos].second > parentDepth){
-				excludedNodes.insert((*c).getElementAt(parentPos));
+				excludedNodes.insert(pl.at(parentPos));
 				parentPos -= 1;
 				continue;
 			}
 			if ((*label)[parentPos].second >= (*label)[lastChildPos].second){
-				excludedNodes.insert((*c).getElementAt(parentPos));
+				excludedNodes.insert(pl.at(parentPos));
 				parentPos -= 1;
 				continue;
 			}
 
 			if (undirectedGraph){
-				excludedNodes.insert((*c).getElementAt(parentPos));
+				excludedNodes.insert(pl.at(parentPos));
 			}
-			int parentNodeId = (*c).getElementAt(parentPos);
-			const NodeInfo* parentNode =
-					&listNodes[(*c).getNbTree()][parentNodeId];
+			int parentNodeId = pl.at(parentPos);
+			const Dataset::Node parentNode =
+					listNodes[(*c).getNbTree()][parentNodeId];
 
-			set<int>::iterator start = parentNode->childNodes.begin();
-			set<int>::iterator end = parentNode->childNodes.end();
-			set<int> childNodes;
+			Dataset::Range::const_iterator start = parentNode.childNodes.begin();
+			Dataset::Range::const_iterator end = parentNode.childNodes.end();
+			vector<int> childNodes;
 			if (maximumGap != 0){
 				collectAllChilds(listNodes[(*c).getNbTree()], parentNodeId, maximumGap, childNodes);
-				start = childNodes.begin();
-				end = childNodes.end();
+				start = childNodes.data();
+				end = childNodes.data() + childNodes.size();
 			}
 
-			for (set<int>::iterator it = start ; it != end; it++){
+			for (Dataset::Range::const_iterator it = start ; it != end; it++){
 				if (excludedNodes.count(*it) > 0){
 					continue;
 				}
 				if (maximumGap != 0){
-					collectAllChilds(listNodes[(*c).getNbTree()], (*c).getElementAt(parentPos+1), maximumGap, excludedNodes);
+					collectAllChilds(listNodes[(*c).getNbTree()], pl.at(parentPos+1), maximumGap, excludedNodes);
 				}
 
-				const NodeInfo* nodeIdi = &listNodes[(*c).getNbTree()][*it];
-				if (!nodeIdi->isFrequent()) {
+				const Dataset::Node nodeIdi = listNodes[(*c).getNbTree()][*it];
+				if (!nodeIdi.isFrequent()) {
 					continue;
 				}
 
@@ -1630,7 +1614,7 @@ void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo>
 					for (int j = parentPos + 1;
 							j <= lastChildPos;
 							j++) {
-						int childId = (*c).getElementAt(j);
+						int childId = pl.at(j);
 						if (((*label)[j]).second == ((*label)[parentPos]).second + 1) {
 
 							if (*it == childId){
@@ -1652,8 +1636,8 @@ void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo>
 				const int depth = (*label)[parentPos].second + 1;
 
 				int reentrantNodeIndex = -1;
-				for (uint i = 0 ; i < (*c).getPathList().size() ; i++){
-					if ((*c).getPathList()[i] == *it){
+				for (uint i = 0 ; i < pl.size() ; i++){
+					if (pl[i] == *it){
 						reentrantNodeIndex = i;
 						break;
 					}
@@ -1661,78 +1645,86 @@ void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo>
 				if (reentrantNodeIndex != -1){
 					// try to add an edge to an existing node
 					int reentrantCode = -(reentrantNodeIndex+1);
-					vector<SequenceInfo>* pvsi;
+					int newCandidate;
 					if (memoLp.count(pair<int, int>(reentrantCode, depth)) > 0) {
-						pvsi = memoLp[pair<int, int>(reentrantCode, depth)];
+						newCandidate = memoLp[pair<int, int>(reentrantCode, depth)];
 					} else {
-						vector<pair<set<int>, int> > labelPath;
-						labelPath = *label;
-						set<int> labelSet;
+						ItemSet labelSet;
 						labelSet.insert(reentrantCode);
 						labelSet.insert(999);
+						pair<ItemSet, int> newNode(labelSet, depth);
 
-						labelPath.push_back(
-								pair<set<int>, int>(labelSet, depth));
-
-						pvsi = &candidates.newCandidates[labelPath].subtrees;
-						memoLp[pair<int, int>(reentrantCode, depth)] = pvsi;
+						CanonicalState state;
+						if (!orderedSearch) {
+							state = *canonicalState;
+							state.append(replacedLabel,
+									pair<ItemSet, int>(replacedLabel[reentrantNodeIndex].first, depth));
+						}
+						newCandidate = extensions.addCandidate(newNode, state);
+						memoLp[pair<int, int>(reentrantCode, depth)] = newCandidate;
 						if (verbose){
-							cout <<"generated pattern : " << serialize(labelPath) << endl;
+							vector<pair<ItemSet, int> > labelPath = *label;
+							labelPath.push_back(newNode);
+							writeOutput("generated pattern : " + serialize(labelPath) + "\n");
 						}
 					}
 
-					vector<int> path = (*c).getPathList();
-					path.push_back(*it);
-					SequenceInfo si = SequenceInfo((*c).getNbTree(), path);
-					pvsi->push_back(si);
+					SequenceInfo si = SequenceInfo((*c).getNbTree(),
+							extensions.embeddings.add((*c).getEmbedding(), *it), *it);
+					extensions.addSubtree(newCandidate, si);
 					continue;
 				}
 
-				for (set<int>::const_iterator labelIt =
-						listNodes[(*c).getNbTree()][*it].labels.begin();
-						labelIt != listNodes[(*c).getNbTree()][*it].labels.end();
+				for (Dataset::Range::const_iterator labelIt =
+						nodeIdi.labels.begin();
+						labelIt != nodeIdi.labels.end();
 						labelIt++) {
-					if (!orderedSearch && labelsGeneratingNonCanonicalPatterns[parentPos].count(*labelIt)> 0){
+					if (!orderedSearch && getLabelStatus(labelStatus[parentPos+1], *labelIt) == NON_CANONICAL_LABEL){
 						continue; // there is no need to add this node
 					}
 
 					if (!orderedSearch
 							&& (*labelIt < *((*label)[lastChildPos].first.begin()))) {
-						labelsGeneratingNonCanonicalPatterns[parentPos].insert(*labelIt);
+						getLabelStatus(labelStatus[parentPos+1], *labelIt) = NON_CANONICAL_LABEL;
 						continue;
 					}
-					vector<SequenceInfo>* pvsi;
+					if (countUnique && !canBeFrequent(labelBounds, *trees, *labelIt)) {
+						continue;
+					}
+					int newCandidate;
 					if (memoLp.count(pair<int, int>(*labelIt, depth)) > 0) {
-						pvsi = memoLp[pair<int, int>(*labelIt, depth)];
+						newCandidate = memoLp[pair<int, int>(*labelIt, depth)];
 					} else {
-						vector<pair<set<int>, int> > labelPath;
+						vector<pair<ItemSet, int> > labelPath;
 						labelPath = *label;
-						set<int> labelSet;
+						ItemSet labelSet;
 						labelSet.insert(*labelIt);
 
 						labelPath.push_back(
-								pair<set<int>, int>(labelSet, depth));
+								pair<ItemSet, int>(labelSet, depth));
+						CanonicalState state;
 						if (!orderedSearch){
-							if (labelsGeneratingCanonicalPatterns[parentPos].count(*labelIt) == 0){
-								if (isCanonical(labelPath) != 1) {
-									labelsGeneratingCanonicalPatterns[parentPos].insert(*labelIt);
+							if (getLabelStatus(labelStatus[parentPos+1], *labelIt) == UNKNOWN_LABEL){
+								state = *canonicalState;
+								state.append(replacedLabel, labelPath.back());
+								if (state.getForm() != 1) {
+									getLabelStatus(labelStatus[parentPos+1], *labelIt) = CANONICAL_LABEL;
 								} else{
-									labelsGeneratingNonCanonicalPatterns[parentPos].insert(*labelIt);
+									getLabelStatus(labelStatus[parentPos+1], *labelIt) = NON_CANONICAL_LABEL;
 									continue;
 								}
 							}
 						}
-						pvsi = &candidates.newCandidates[labelPath].subtrees;
-						memoLp[pair<int, int>(*labelIt, depth)] = pvsi;
+						newCandidate = extensions.addCandidate(labelPath.back(), state);
+						memoLp[pair<int, int>(*labelIt, depth)] = newCandidate;
 						if (verbose){
-							cout <<"generated pattern : " << serialize(labelPath) << endl;
+							writeOutput("generated pattern : " + serialize(labelPath) + "\n");
 						}
 					}
 
-					vector<int> path = (*c).getPathList();
-					path.push_back(*it);
-					SequenceInfo si = SequenceInfo((*c).getNbTree(), path);
-					pvsi->push_back(si);
+					SequenceInfo si = SequenceInfo((*c).getNbTree(),
+							extensions.embeddings.add((*c).getEmbedding(), *it), *it);
+					extensions.addSubtree(newCandidate, si);
 				}
 			}
 			lastChildPos = parentPos;
@@ -1741,49 +1733,550 @@ void extendFirstCandidate(Candidates& candidates, const vector<vector<NodeInfo>
 			excludedNodes.clear();
 		}
 	}
-	candidates.removeCandidate(closedItemsetSearch || closedSequenceSearch);
-	return;
 }
 
-void performJoin(Candidates& candidates,
-		const vector<vector<NodeInfo> >& listNodes) {
-	extendFirstCandidate(candidates, listNodes);
-	candidates.storeNewCandidates();
+/**
+ * Sorts the nodes of an embedding from a position and removes duplicates
+ * (a reentrant node appears twice), so that these nodes compare as a set.
+ * @param path the nodes of an embedding
+ * @param from the position of the first sorted node
+ */
+void sortNodes(vector<int>& path, int from) {
+	std::sort(path.begin() + from, path.end());
+	path.erase(std::unique(path.begin() + from, path.end()), path.end());
 }
 
-void initializeCandidates(Candidates& candidates,
-		const vector<vector<NodeInfo> >& nodes) {
-	int nbreducedCandidates = 0;
-	int nbCandidates = 0;
-	for (int t = 0; t < (int) nodes.size(); t++) {
-		set<string> subtreesPerCandidates;
-		set<int> ignoredNodes;
-		for (int i = 0; i < (int) nodes[t].size(); i++) {
-			if ((maximumGap != 0) && countUnique
-					&& (ignoredNodes.count(i) > 0)) {
-				continue;
-			}
-			if (!nodes[t][i].isFrequent()) {
-				continue;
-			}
-			if (rootedTreeSearch && nodes[t][i].depth != 0) {
-				continue;
+/**
+ * Records the trees of a pattern whose support is computed, when a state
+ * file is used.
+ * While the appended trees are searched, the support of the patterns that
+ * were not recorded by the previous searches is bounded by the number of
+ * trees in which the labels of their last node were not recorded.
+ * @param pattern the text of the pattern
+ * @param label the label of the pattern
+ * @param trees the trees containing the pattern
+ */
+void recordPattern(const string& pattern, const vector<pair<ItemSet, int> >& label,
+		const TreeBitmap& trees) {
+	if (!countAppendedTrees) {
+		IncrementalState::Entry& entry = incrementalState.get(pattern);
+		entry.trees.clear();
+		entry.trees.merge(trees, incrementalState.firstTree);
+		return;
+	}
+	IncrementalState::Entry& entry = appendedState.get(pattern);
+	entry.trees = trees;
+	if (incrementalState.find(pattern) == NULL) {
+		// the extensions of the extended patterns are recorded, except the
+		// ones with labels that were not frequent enough
+		entry.unknownTrees = 0;
+		const ItemSet& lastNode = label.back().first;
+		if (*lastNode.begin() >= 0) {
+			for (ItemSet::const_iterator it = lastNode.begin(); it != lastNode.end(); it++) {
+				entry.unknownTrees += incrementalState.getUnknownTrees(labelDictionary[*it]);
 			}
+		}
+	}
+}
 
-			if ((maximumGap != 0) && countUnique) {
-				set<int>::iterator start = nodes[t][i].childNodes.begin();
-				set<int>::iterator end = nodes[t][i].childNodes.end();
-				set<int> childNodes;
-				if (maximumGap != 0){
-					collectAllChilds(nodes[t], i, maximumGap, childNodes);
-					start = childNodes.begin();
-					end = childNodes.end();
-				}
-
-					for (set<int>::iterator itj = start ; itj != end; itj++){
-					if (includes(nodes[t][i].labels.begin(),
-							nodes[t][i].labels.end(),
-							nodes[t][*itj].labels.begin(),
+/**
+ * Generates a new list of candidates from a previous one by appending individual nodes.
+ * @param candidates a list of candidates
+ * @param listNodes a list of nodes
+ */
+void extendFirstCandidate(Candidates& candidates, const Dataset& listNodes) {
+	candidates.markEmbeddings();
+	pair<int, CandidateInfo* >* candi = &candidates.currentCandidates.back();
+	const int patternId = candi->first;
+	vector<pair<ItemSet, int> > labelOfCandidate;
+	candidates.getLabel(patternId, labelOfCandidate);
+	const vector<pair<ItemSet, int> >* label = &labelOfCandidate;
+	CandidateInfo* candidateInfo = candi->second;
+	vector<SequenceInfo>* values = &(candi->second->subtrees);
+
+		if (patternSearch) {
+			if (!containsPattern(candidates, patternId)) {
+				candidates.removeCandidate(false);
+				return;
+			}
+		}
+
+	int count = candidateInfo->support;
+	if (count == CandidateInfo::UNKNOWN_SUPPORT) {
+		count = countMotifs(*candidateInfo, candidates.embeddings);
+	}
+	int nbOfOccurences = getNbOccurences(values);
+
+	string patternText;
+	if (recordPatterns || countAppendedTrees) {
+		patternText = getPatternText(candidates, *label);
+		recordPattern(patternText, *label, candidateInfo->trees);
+		if (countAppendedTrees && !incrementalState.isExtended(patternText)) {
+			// only the frequent patterns of the previous searches are extended
+			candidates.removeCandidate(false);
+			return;
+		}
+	}
+
+	if (count < absoluteSupport) {
+		candidates.removeCandidate(false);
+		return;
+	}
+
+	if (!candidateInfo->canonicalState.isKnown()) {
+		candidateInfo->canonicalState.build(*label);
+	}
+	if (candidateInfo->canonicalForm == CandidateInfo::UNKNOWN_FORM) {
+		candidateInfo->canonicalForm = candidateInfo->canonicalState.getForm();
+	}
+	int canonical = candidateInfo->canonicalForm;
+	int canonicalCycle = -1;
+	if (certificateCanonicity) {
+		if ((canonical != 1) && CertificateIndex::containsReentrantNode(*label)
+				&& !certificates.isCanonical(*label, undirectedGraph)) {
+			canonicalCycle = 1;
+		}
+	} else if ((canonical != 1) && *(label->back().first.begin()) == -1){
+		// test the canonicity of a pattern with cycle
+		canonicalCycle = isCycleCanonical(*label);
+	}
+
+	if (!orderedSearch && ((canonical == 1) || (canonicalCycle ==1))) {
+		candidates.removeCandidate(false);
+		return;
+	}
+
+	bool extensionOfLastNodeAllowed = true;
+	if (!orderedSearch && (canonical == 0)) {
+		extensionOfLastNodeAllowed = false;
+		int option = 2;
+		if (option ==1){
+			//only sibblings can be added to this pattern
+			// we can keep only one occurence of path with the same right hand path
+			vector<int> rightPathElts;
+			int rightPathElt = label->size()-1;
+			while (rightPathElt != -1) {
+				rightPathElts.insert(rightPathElts.begin(),rightPathElt);
+				rightPathElt = getParent(*label, rightPathElt);
+			}
+
+			set<pair<int,vector<int> > > pathsToRemove;
+			vector<SequenceInfo> newValue;
+			vector<int> pathList;
+			for (vector<SequenceInfo>::iterator it = values->begin();
+					it != values->end();it++) {
+				candidates.embeddings.getPath(it->getEmbedding(), pathList);
+				vector<int> rightPathContent;
+				for (uint i = 0 ; i < rightPathElts.size() ; i++){
+					rightPathContent.push_back(pathList[i]);
+				}
+				pair<int,vector<int> > elt = pair<int,vector<int> >(it->getNbTree(), rightPathContent);
+				if (pathsToRemove.count(elt) > 0){
+				} else{
+					pathsToRemove.insert(elt);
+					newValue.push_back(*it);
+				}
+			}
+			values->clear();
+			values->insert(values->end(),newValue.begin(),newValue.end());
+		}
+		else if (option ==2){
+			// embeddings covering the same nodes are images of each other by an
+			// automorphism of the pattern, only the first one is kept
+			unordered_set<vector<int>, IntSequenceHash> nodeSets(2 * values->size());
+			vector<int> pathList;
+			vector<SequenceInfo>::iterator kept = values->begin();
+			for (vector<SequenceInfo>::iterator it = values->begin();
+					it != values->end();it++) {
+				candidates.embeddings.getPath(it->getEmbedding(), pathList);
+				sortNodes(pathList, 0);
+				if (nodeSets.insert(pathList).second){
+					*kept++ = *it;
+				}
+			}
+			if (verbose) {
+				ostringstream out;
+				out << "reduction of instances (automorph)" << values->size() << " to " << (kept - values->begin()) << endl;
+				writeOutput(out.str());
+			}
+			values->erase(kept, values->end());
+		}
+	}
+	bool newOptimisation = true;
+	if (newOptimisation){
+		if ((label->back().second == 1) && (label->back().first.size() ==1)){
+			int posOfPreviousSibling = getPreviousSibbling(*label, label->size()-1);
+			if ((posOfPreviousSibling != -1) && (*((*label)[posOfPreviousSibling].first.begin()) < *(label->back().first.begin()))){
+				unordered_set<vector<int>, IntSequenceHash> pathElts(2 * values->size());
+				unordered_set<int> lastElt(2 * values->size());
+				vector<int> pathList;
+				vector<SequenceInfo>::iterator kept = values->begin();
+				for (vector<SequenceInfo>::iterator it = values->begin();
+						it != values->end();it++) {
+					candidates.embeddings.getPath(it->getEmbedding(), pathList);
+					const int last = pathList.back();
+					pathList.pop_back();
+					sortNodes(pathList, 0);
+					bool knownNodes = !pathElts.insert(pathList).second;
+					bool knownLast = !lastElt.insert(last).second;
+					if (!knownNodes || !knownLast){
+						*kept++ = *it;
+					}
+				}
+				if (verbose) {
+					ostringstream out;
+					out << "reduction of instances(opt1)" << values->size() << " to " << (kept - values->begin()) << endl;
+					writeOutput(out.str());
+				}
+				values->erase(kept, values->end());
+			}
+		}
+	}
+
+	bool newOptimisation2 = true;
+	if (newOptimisation2){
+		vector<int> rightPathElts;
+		int rightPathElt = label->size()-1;
+		while (rightPathElt != -1) {
+			rightPathElts.insert(rightPathElts.begin(),rightPathElt);
+			rightPathElt = getParent(*label, rightPathElt);
+		}
+		for (uint i = 1 ; i < rightPathElts.size()-1 ; i++){
+			vector<pair<ItemSet, int> > labelFromParent;
+			labelFromParent.insert(labelFromParent.begin(), label->begin()+rightPathElts[i], label->end());
+			bool good = true;
+			for (vector<pair<ItemSet, int> >::iterator it = labelFromParent.begin() ; it < labelFromParent.end() ; it++){
+				if (*(it->first.begin()) < 0){
+					good = false;
+					break;
+				}
+			}
+			if (good && isCanonical(labelFromParent) ==0 ){
+				// the nodes before the subtree are kept in order, the nodes of
+				// the subtree are compared as a set
+				unordered_set<vector<int>, IntSequenceHash> pathElts(2 * values->size());
+				vector<int> pathList;
+				vector<SequenceInfo>::iterator kept = values->begin();
+				for (vector<SequenceInfo>::iterator it = values->begin();
+						it != values->end();it++) {
+					candidates.embeddings.getPath(it->getEmbedding(), pathList);
+					sortNodes(pathList, rightPathElts[i]);
+					if (pathElts.insert(pathList).second){
+						*kept++ = *it;
+					}
+				}
+				if (verbose) {
+					ostringstream out;
+					out << "reduction of instances(opt2)" << values->size() << " to " << (kept - values->begin()) << endl;
+					writeOutput(out.str());
+				}
+				values->erase(kept, values->end());
+				break;
+
+			}
+
+		}
+	}
+	bool closedCandidate = false;
+	if (closedItemsetSearch && itemSetMining) {
+		pair<int, int> inheritedCount = getInheritedCount(candidates, *label);
+
+		if (inheritedCount.first > 0
+				&& inheritedCount.second == nbOfOccurences) {
+			if (!closedCandidate && closedSequenceSearch) {
+				candidates.setSuperCount(patternId, candidateInfo, count, nbOfOccurences);
+			}
+			if (closedSequenceSearch) {
+				candidates.setClosed(candidateInfo);
+			}
+			candidates.removeCandidate(closedItemsetSearch || closedSequenceSearch);
+			return;
+		}
+		if (inheritedCount.first >= count) {
+			closedCandidate = true;
+		}
+	}
+
+	if (itemSetMining && extensionOfLastNodeAllowed) {
+		vector<CandidateInfo*> memoLp(nbLabels, (CandidateInfo*) NULL);
+		vector<char> labelBounds;
+
+		set<int> superSequences;
+		for (vector<SequenceInfo>::const_iterator c = values->begin();
+				c != values->end(); c++) {
+			int n = (*c).getLast();
+			const Dataset::Node nodeId = listNodes[(*c).getNbTree()][n];
+
+			// add an item to the itemset of the last node
+			const ItemSet& currentLabel = label->back().first;
+			if (nodeId.labels.size() > 1) {
+				for (Dataset::Range::const_iterator labelIt = nodeId.labels.begin();
+						labelIt != nodeId.labels.end(); labelIt++) {
+					if ((*labelIt) > (*currentLabel.rbegin())) {
+						if (countUnique && !canBeFrequent(labelBounds, candidateInfo->trees, *labelIt)) {
+							continue;
+						}
+						CandidateInfo* newCandidate;
+						if (memoLp[*labelIt] != NULL) {
+							newCandidate = memoLp[*labelIt];
+						} else {
+							pair<ItemSet, int> lastNode = label->back();
+							lastNode.first.insert(*labelIt);
+							int parentId = candidates.patterns.getParent(patternId);
+							newCandidate = &candidates.addNewCandidate(parentId, lastNode);
+							if (closedItemsetSearch) {
+								superSequences.insert(candidates.patterns.find(parentId, lastNode));
+							}
+							memoLp[*labelIt] = newCandidate;
+							if (verbose){
+								vector<pair<ItemSet, int> > labelPath = *label;
+								labelPath.back() = lastNode;
+								writeOutput("generated pattern : " + serialize(labelPath) + "\n");
+							}
+						}
+						newCandidate->addSubtree(*c);
+					}
+				}
+			}
+		}
+
+		if (closedItemsetSearch) {
+			bool identicalSuperset = false;
+
+			for (set<int>::const_iterator supIt =
+					superSequences.begin(); supIt != superSequences.end();
+					supIt++) {
+
+				if (getNbOccurencesByLabel(candidates, *supIt) == nbOfOccurences) {
+					identicalSuperset = true;
+				}
+				if (countMotifsByLabel(candidates, *supIt) == count) {
+					closedCandidate = true;
+
+					if (closedSequenceSearch) {
+						candidates.setClosed(candidateInfo);
+						candidates.setSuperCount(patternId, candidateInfo, count, nbOfOccurences);
+					}
+				}
+			}
+
+			// if a candidates, created by adding a new item to the last itemset
+			// has the same occurence of the current pattern, then, the extension of
+			// the current pattern is not needed
+			// in addition, the current pattern is redundant
+			if (identicalSuperset) {
+				candidates.removeNewCandidate(patternId);
+				if (closedSequenceSearch) {
+					candidates.setClosed(candidateInfo);
+					candidates.setSuperCount(patternId, candidateInfo, count, nbOfOccurences);
+				}
+
+				return;
+			}
+		}
+	}
+
+	if (!closedCandidate && closedSequenceSearch) {
+		markPreviousNonClosedCandidates(candidates, *label, count);
+		pair<int, int> inheritedCount = getInheritedCountStructural(candidates, *label);
+
+		if (inheritedCount.first >= count) {
+			closedCandidate = true;
+			if (verbose)
+				cout << "closed: " << serialize(*label) << endl;
+		}
+
+	}
+	if (closedItemsetSearch || closedSequenceSearch) {
+		candidates.setSuperCount(patternId, candidateInfo, count, nbOfOccurences);
+		if (closedCandidate && closedSequenceSearch) {
+			candidates.setClosed(candidateInfo);
+		}
+	}
+
+	if ((topK > 0) && (closedItemsetSearch || closedSequenceSearch)) {
+		int support = absoluteSupport;
+		{
+			lock_guard<mutex> lock(outputMutex);
+			addTopDistinctSupport(count);
+		}
+		if (absoluteSupport > support) {
+			candidates.removeUnfrequent(absoluteSupport, countUnique);
+		}
+	}
+
+	if (recordPatterns) {
+		incrementalState.setExtended(patternText);
+	}
+
+	if (outputFrequentTrees && !closedCandidate && !closedSequenceSearch
+			&& !countAppendedTrees) {
+		if (!patternSearch) {
+			int support = absoluteSupport;
+			writeSolution(candidates, *label, count);
+			if (absoluteSupport > support) {
+				candidates.removeUnfrequent(absoluteSupport, countUnique);
+			}
+		} else {
+			int basePattern = matchesPattern(candidates, *candidateInfo, *label, listNodes);
+			if (basePattern != -1) {
+				writeSolutionForSearchPattern(candidates, *label, count, basePattern);
+			}
+		}
+	}
+
+	// the embeddings are split by tree between the extending thread and
+	// the threads lent by hungry workers
+	int nbChunks = 1;
+	if (nbThreads > 1) {
+		int wanted = min(nbThreads, (int) values->size() / minEmbeddingsPerThread) - 1;
+		nbChunks += reserveHelpers(wanted);
+	}
+	vector<vector<SequenceInfo>::const_iterator> bounds;
+	bounds.push_back(values->begin());
+	for (int i = 1; i < nbChunks; i++) {
+		vector<SequenceInfo>::const_iterator bound = values->begin() + (values->size() * i) / nbChunks;
+		while ((bound != values->end()) && (bound != bounds.back())
+				&& ((bound - 1)->getNbTree() == bound->getNbTree())) {
+			bound++;
+		}
+		bounds.push_back(bound);
+	}
+	bounds.push_back(values->end());
+
+	vector<ExtensionBuffer> extensions(nbChunks);
+	vector<thread> helpers;
+	for (int i = 1; i < nbChunks; i++) {
+		helpers.push_back(thread(extendEmbeddings, &candidates, &listNodes, label,
+				&candidateInfo->canonicalState, &candidateInfo->trees, extensionOfLastNodeAllowed,
+				bounds[i], bounds[i + 1], &extensions[i]));
+	}
+	extendEmbeddings(&candidates, &listNodes, label, &candidateInfo->canonicalState,
+			&candidateInfo->trees, extensionOfLastNodeAllowed,
+			bounds[0], bounds[1], &extensions[0]);
+	for (int i = 0; i < (int) helpers.size(); i++) {
+		helpers[i].join();
+	}
+	releaseHelpers(nbChunks - 1);
+	// merged in the order of the embeddings, as a sequential extension
+	for (int i = 0; i < nbChunks; i++) {
+		candidates.mergeExtensions(patternId, extensions[i]);
+	}
+	if ((topK > 0) && (closedItemsetSearch || closedSequenceSearch) && countUnique) {
+		// the supports of the extensions are known from their trees
+		int support = absoluteSupport;
+		{
+			lock_guard<mutex> lock(outputMutex);
+			for (unordered_map<int, CandidateInfo >::iterator candIt = candidates.newCandidates.begin();
+					candIt != candidates.newCandidates.end(); candIt++) {
+				candIt->second.support = candIt->second.trees.count(patternsCount);
+				addTopDistinctSupport(candIt->second.support);
+			}
+		}
+		if (absoluteSupport > support) {
+			candidates.removeUnfrequent(absoluteSupport, countUnique);
+		}
+	}
+	candidates.removeCandidate(closedItemsetSearch || closedSequenceSearch);
+	return;
+}
+
+void performJoin(Candidates& candidates,
+		const Dataset& listNodes) {
+	extendFirstCandidate(candidates, listNodes);
+	candidates.storeNewCandidates();
+}
+
+/**
+ * Extends candidates until no worker has candidates left.
+ * A worker whose stack is empty waits for a task ; busy workers give the
+ * bottom of their stack to waiting workers.
+ * @param candidates the candidates of the worker
+ * @param listNodes a list of nodes
+ */
+void mineWithWorker(Candidates* candidates, const Dataset* listNodes) {
+	MiningTask task;
+	while (true) {
+		if (candidates->currentCandidates.empty()) {
+			unique_lock<mutex> lock(taskMutex);
+			idleWorkers += 1;
+			hungryWorkers += 1;
+			while (sharedTasks.empty() && (idleWorkers < nbThreads)) {
+				taskAvailable.wait(lock);
+			}
+			if (sharedTasks.empty()) {
+				// all workers are idle: the search is over
+				taskAvailable.notify_all();
+				return;
+			}
+			idleWorkers -= 1;
+			hungryWorkers -= 1;
+			std::swap(task, sharedTasks.front());
+			sharedTasks.pop_front();
+			lock.unlock();
+			candidates->receiveCandidate(task);
+		} else if ((hungryWorkers > 0) && (candidates->currentCandidates.size() > 1)) {
+			lock_guard<mutex> lock(taskMutex);
+			if (hungryWorkers > (int) sharedTasks.size()) {
+				sharedTasks.push_back(MiningTask());
+				candidates->donateCandidate(sharedTasks.back());
+				taskAvailable.notify_one();
+			}
+		}
+		performJoin(*candidates, *listNodes);
+	}
+}
+
+/**
+ * Performs the search with nbThreads workers.
+ * @param candidates the initial candidates
+ * @param listNodes a list of nodes
+ */
+void mineInParallel(Candidates& candidates, const Dataset& listNodes) {
+	vector<Candidates> workerCandidates(nbThreads - 1);
+	vector<thread> workers;
+	for (int w = 0; w < nbThreads - 1; w++) {
+		workers.push_back(thread(mineWithWorker, &workerCandidates[w], &listNodes));
+	}
+	mineWithWorker(&candidates, &listNodes);
+	for (int w = 0; w < nbThreads - 1; w++) {
+		workers[w].join();
+	}
+}
+
+void initializeCandidates(Candidates& candidates,
+		const Dataset& nodes) {
+	int nbreducedCandidates = 0;
+	int nbCandidates = 0;
+	for (int t = 0; t < (int) nodes.size(); t++) {
+		set<string> subtreesPerCandidates;
+		set<int> ignoredNodes;
+		for (int i = 0; i < (int) nodes[t].size(); i++) {
+			if ((maximumGap != 0) && countUnique
+					&& (ignoredNodes.count(i) > 0)) {
+				continue;
+			}
+			if (!nodes[t][i].isFrequent()) {
+				continue;
+			}
+			if (rootedTreeSearch && nodes[t][i].depth != 0) {
+				continue;
+			}
+
+			if ((maximumGap != 0) && countUnique) {
+				Dataset::Range::const_iterator start = nodes[t][i].childNodes.begin();
+				Dataset::Range::const_iterator end = nodes[t][i].childNodes.end();
+				vector<int> childNodes;
+				if (maximumGap != 0){
+					collectAllChilds(nodes[t], i, maximumGap, childNodes);
+					start = childNodes.data();
+					end = childNodes.data() + childNodes.size();
+				}
+
+					for (Dataset::Range::const_iterator itj = start ; itj != end; itj++){
+					if (includes(nodes[t][i].labels.begin(),
+							nodes[t][i].labels.end(),
+							nodes[t][*itj].labels.begin(),
 							nodes[t][*itj].labels.end())) {
 						ignoredNodes.insert(*itj);
 					}
@@ -1811,8 +2304,9 @@ void initializeCandidates(Candidates& candidates,
 				}
 			}
 			if (oktoadd){
-				for (set<int>::const_iterator lIt = nodes[t][i].labels.begin();
-						lIt != nodes[t][i].labels.end(); lIt++) {
+				const Dataset::Range labels = nodes[t][i].labels;
+				for (Dataset::Range::const_iterator lIt = labels.begin();
+						lIt != labels.end(); lIt++) {
 					if (useOnlyThisRoot != -1){
 						if (useOnlyThisRoot != *lIt) continue;
 					}
@@ -1827,22 +2321,58 @@ void initializeCandidates(Candidates& candidates,
 	}
 }
 
-void getfrequentNodes(const vector<vector<NodeInfo> >& allNodes,
+/**
+ * Raises the min support, in top-k mode, to the support of the k-th most
+ * frequent label: each label is a pattern, so the k best patterns have at
+ * least this support. Only distinct supports are used for closed patterns.
+ * Not done when labels are excluded from the patterns.
+ * @param supports the support of each label
+ */
+void raiseSupportToTopLabels(vector<int>& supports) {
+	if (closedItemsetSearch || closedSequenceSearch) {
+		std::sort(supports.begin(), supports.end());
+		supports.erase(std::unique(supports.begin(), supports.end()), supports.end());
+	}
+	if ((topK <= 0) || ((int) supports.size() < topK)) {
+		return;
+	}
+	if (!useOnlyTheseLabels.empty() || !excludeTheselabels.empty()
+			|| (useOnlyThisRoot != -1) || rootedTreeSearch) {
+		return;
+	}
+	std::nth_element(supports.begin(), supports.begin() + topK - 1, supports.end(), greater<int>());
+	if (supports[topK - 1] > absoluteSupport) {
+		absoluteSupport = supports[topK - 1];
+		if (verbose) {
+			cout << "absolute support is raised to " << absoluteSupport << endl;
+		}
+	}
+}
+
+void getfrequentNodes(const Dataset& allNodes,
 		set<int>& frequents) {
 	int frequentCount = 0;
+	vector<int> supports;
 	if (!countUnique) {
 		map<int, int> count;
 
-		for (vector<vector<NodeInfo> >::const_iterator t = allNodes.begin();
-				t != allNodes.end(); t++) {
-			for (vector<NodeInfo>::const_iterator ni = (*t).begin();
-					ni != (*t).end(); ni++) {
-				for (set<int>::const_iterator l = ni->labels.begin();
-						l != ni->labels.end(); l++) {
+		for (int i = 0; i < (int) allNodes.size(); i++) {
+			const Dataset::Graph graph = allNodes[i];
+			for (int n = 0; n < graph.size(); n++) {
+				const Dataset::Range labels = graph[n].labels;
+				for (Dataset::Range::const_iterator l = labels.begin();
+						l != labels.end(); l++) {
 					count[*l] += 1;
 				}
 			}
 		}
+		for (map<int, int>::const_iterator it = count.begin(); it != count.end();
+				it++) {
+			if (it->second <= absoluteMaxSupport) {
+				supports.push_back(it->second);
+			}
+		}
+		raiseSupportToTopLabels(supports);
 		for (map<int, int>::const_iterator it = count.begin(); it != count.end();
 				it++) {
 			if ((it->second >= absoluteSupport) && (it->second <= absoluteMaxSupport)) {
@@ -1857,14 +2387,22 @@ void getfrequentNodes(const vector<vector<NodeInfo> >& allNodes,
 		map<int, set<int> > count;
 
 		for (int i = 0; i < (int) allNodes.size(); i++) {
-			for (vector<NodeInfo>::const_iterator ni = allNodes[i].begin();
-					ni != allNodes[i].end(); ni++) {
-				for (set<int>::const_iterator l = ni->labels.begin();
-						l != ni->labels.end(); l++) {
+			const Dataset::Graph graph = allNodes[i];
+			for (int n = 0; n < graph.size(); n++) {
+				const Dataset::Range labels = graph[n].labels;
+				for (Dataset::Range::const_iterator l = labels.begin();
+						l != labels.end(); l++) {
 					count[*l].insert(i);
 				}
 			}
 		}
+		for (map<int, set<int> >::const_iterator it = count.begin();
+				it != count.end(); it++) {
+			if ((int) it->second.size() <= absoluteMaxSupport) {
+				supports.push_back(it->second.size());
+			}
+		}
+		raiseSupportToTopLabels(supports);
 		for (map<int, set<int> >::const_iterator it = count.begin();
 				it != count.end(); it++) {
 			if (verbose) {
@@ -1878,19 +2416,25 @@ void getfrequentNodes(const vector<vector<NodeInfo> >& allNodes,
 		}
 	}
 }
-void removeUnfrequentNodes(vector<vector<NodeInfo> >& allNodes,
+void removeUnfrequentNodes(Dataset& allNodes,
 		const set<int>& frequents) {
-	for (vector<vector<NodeInfo> >::iterator t = allNodes.begin();
-			t != allNodes.end(); t++) {
-		for (vector<NodeInfo>::iterator ni = (*t).begin(); ni != (*t).end();
-				ni++) {
-
-			for (set<int>::iterator l = ni->labels.begin();
-					l != ni->labels.end();) {
-				std::set<int>::iterator current = l++;
-				if (frequents.count(*current) == 0){
-					ni->labels.erase(current);
-				}
+	allNodes.filterLabels(frequents);
+}
+
+/**
+ * Collects the trees containing each label.
+ * @param allNodes the list of all items in the dataset
+ * @param trees the trees of each label
+ */
+void collectLabelTrees(const Dataset& allNodes, vector<TreeBitmap>& trees) {
+	trees.assign(nbLabels, TreeBitmap());
+	for (int i = 0; i < (int) allNodes.size(); i++) {
+		const Dataset::Graph graph = allNodes[i];
+		for (int n = 0; n < graph.size(); n++) {
+			const Dataset::Range labels = graph[n].labels;
+			for (Dataset::Range::const_iterator l = labels.begin();
+					l != labels.end(); l++) {
+				trees[*l].add(i);
 			}
 		}
 	}
@@ -1903,7 +2447,7 @@ void removeUnfrequentNodes(vector<vector<NodeInfo> >& allNodes,
  * @return 1 if the processing is OK ; -1 if the process fails
  */
 int initializePatternNodes(const string& fileName,
-		vector<vector<NodeInfo> >& patternNodes,
+		Dataset& patternNodes,
 		vector<float>& patternFrequencies) {
 	int inputFormat = getInputFormat(inputFile);
 	if (inputFormat != 1) {
@@ -1920,11 +2464,7 @@ int initializePatternNodes(const string& fileName,
 
 	if (verbose) {
 		cout << "size of patternSet : " << nbTrees << endl;
-		int nodeCount = 0;
-		for (vector<vector<NodeInfo> >::const_iterator it = patternNodes.begin();
-				it != patternNodes.end(); it++) {
-			nodeCount += it->size();
-		}
+		int nodeCount = patternNodes.getNbNodes();
 		cout << "total number of nodes in patternSet: " << nodeCount << endl;
 	}
 
@@ -1932,14 +2472,14 @@ int initializePatternNodes(const string& fileName,
 }
 
 /**
- * initializeInputNodes collects items and compute their occurences in the dataset.
+ * Reads the trees of an input file.
  * @param fileName the name of the file that contain the data.
- * @param allNodes the list of all items in the input dataset.
- * @return 1 if the processing is OK ; -1 if the process fails
+ * @param inputNodes the list of all items in the input dataset.
+ * @return 0 if the processing is OK ; -1 if the process fails
  */
-int initializeInputNodes(const string& fileName,
-		vector<vector<NodeInfo> >& inputNodes) {
-	int inputFormat = getInputFormat(inputFile);
+int loadInputNodes(const string& fileName,
+		Dataset& inputNodes) {
+	int inputFormat = getInputFormat(fileName);
 	if (verbose) {
 		cout << "detected input format = ";
 		switch (inputFormat) {
@@ -1951,33 +2491,55 @@ int initializeInputNodes(const string& fileName,
 	}
 	int nbTrees = -1;
 	if (inputFormat == 1) {
-		nbTrees = processInputFileSleuth(inputFile, inputNodes);
+		nbTrees = processInputFileSleuth(fileName, inputNodes);
 	} else if (inputFormat == 2) {
-		nbTrees = processInputFileHybrid(inputFile, inputNodes);
+		nbTrees = processInputFileHybrid(fileName, inputNodes);
 	} else if (inputFormat == 3) {
-		nbTrees = processInputFile(inputFile, inputNodes);
+		nbTrees = processInputFile(fileName, inputNodes);
 	} else {
 		return (-1);
 	}
 	if (nbTrees == -1) {
-		cout << "problem while opening file '" << inputFile << "'" << endl;
+		cout << "problem while opening file '" << fileName << "'" << endl;
 		return (-1);
 	}
-	datasetSize = inputNodes.size();
-	if (nbTrees != datasetSize) {
-		cout << "problem reading file '" << inputFile << "'" << endl;
+	if (nbTrees != inputNodes.size()) {
+		cout << "problem reading file '" << fileName << "'" << endl;
 		return (-1);
 	}
-	if (verbose) {
-		cout << "size of dataset : " << datasetSize << endl;
-		int nodeCount = 0;
-		for (vector<vector<NodeInfo> >::const_iterator it = inputNodes.begin();
-				it != inputNodes.end(); it++) {
-			nodeCount += it->size();
+	if (verbose) {
+		cout << "size of dataset : " << inputNodes.size() << endl;
+		int nodeCount = inputNodes.getNbNodes();
+		cout << "total number of nodes : " << nodeCount << endl;
+	}
+	return (0);
+}
+
+/**
+ * Selects the labels that can be used in the patterns.
+ * @param inputNodes the list of all items in the input dataset.
+ * @param frequentNodes the selected labels
+ */
+void selectLabels(const Dataset& inputNodes, set<int>& frequentNodes) {
+	getfrequentNodes(inputNodes, frequentNodes);
+	if (!useOnlyTheseLabels.empty()){
+		frequentNodes = useOnlyTheseLabels;
+	}
+	if (!excludeTheselabels.empty()){
+		for (set<int>::const_iterator it = excludeTheselabels.begin();
+						it != excludeTheselabels.end(); it++) {
+			frequentNodes.erase(*it);
 		}
-		cout << "total number of nodes : " << nodeCount << endl;
 	}
+}
 
+/**
+ * Computes the supports for the size of the dataset and removes the labels
+ * that cannot be used in the patterns.
+ * @param inputNodes the list of all items in the input dataset.
+ */
+void prepareInputNodes(Dataset& inputNodes) {
+	datasetSize = inputNodes.size();
 	if (relativeSupport > 0) {
 		absoluteSupport = inputNodes.size() * relativeSupport;
 		if (verbose) {
@@ -1996,17 +2558,17 @@ int initializeInputNodes(const string& fileName,
 	 * Removing unfrequent nodes
 	 */
 	set<int> frequentNodes;
-	getfrequentNodes(inputNodes, frequentNodes);
-	if (!useOnlyTheseLabels.empty()){
-		frequentNodes = useOnlyTheseLabels;
-	}
-	if (!excludeTheselabels.empty()){
-		for (set<int>::const_iterator it = excludeTheselabels.begin();
-						it != excludeTheselabels.end(); it++) {
-			frequentNodes.erase(*it);
+	selectLabels(inputNodes, frequentNodes);
+	removeUnfrequentNodes(inputNodes, frequentNodes);
+	if (recordPatterns) {
+		// the patterns with the other labels are not recorded
+		for (map<int, int>::const_iterator it = incrementalState.labelTrees.begin();
+				it != incrementalState.labelTrees.end(); it++) {
+			if (frequentNodes.count(it->first) == 0) {
+				incrementalState.unknownLabelTrees[it->first] = it->second;
+			}
 		}
 	}
-	removeUnfrequentNodes(inputNodes, frequentNodes);
 	if (verbose) {
 		string outMessage = "";
 		cout << "nb of frequent items : " << frequentNodes.size() << endl;
@@ -2017,16 +2579,93 @@ int initializeInputNodes(const string& fileName,
 		}
 		cout << endl;
 	}
+}
+
+/**
+ * initializeInputNodes collects items and compute their occurences in the dataset.
+ * @param fileName the name of the file that contain the data.
+ * @param allNodes the list of all items in the input dataset.
+ * @return 1 if the processing is OK ; -1 if the process fails
+ */
+int initializeInputNodes(const string& fileName,
+		Dataset& inputNodes) {
+	if (loadInputNodes(fileName, inputNodes) == -1) {
+		return (-1);
+	}
+	prepareInputNodes(inputNodes);
 	return (0);
 }
 
+/**
+ * Replaces the labels of the dataset by dense values ; the original ones are
+ * only used for output.
+ * @param inputNodes the list of all items in the input dataset.
+ */
+void remapInputLabels(Dataset& inputNodes) {
+	inputNodes.remapLabels(labelDictionary);
+	nbLabels = labelDictionary.size();
+	if (useOnlyThisRoot != -1) {
+		vector<int>::const_iterator root = std::lower_bound(labelDictionary.begin(),
+				labelDictionary.end(), useOnlyThisRoot);
+		if ((root != labelDictionary.end()) && (*root == useOnlyThisRoot)) {
+			useOnlyThisRoot = root - labelDictionary.begin();
+		} else {
+			useOnlyThisRoot = -2; // no node can be used as root
+		}
+	}
+	if (countUnique) {
+		collectLabelTrees(inputNodes, labelTrees);
+	}
+}
+
+/**
+ * Counts the trees containing each label.
+ * @param allNodes the list of all items in the dataset
+ * @param counts the number of trees of each label
+ */
+void countLabelTrees(const Dataset& allNodes, map<int, int>& counts) {
+	for (int i = 0; i < (int) allNodes.size(); i++) {
+		const Dataset::Graph graph = allNodes[i];
+		set<int> labels;
+		for (int n = 0; n < graph.size(); n++) {
+			labels.insert(graph[n].labels.begin(), graph[n].labels.end());
+		}
+		for (set<int>::const_iterator l = labels.begin(); l != labels.end(); l++) {
+			counts[*l] += 1;
+		}
+	}
+}
+
+/**
+ * Returns the options that change the patterns found, a state file is only
+ * used by the searches with the same options.
+ */
+string getSearchSignature() {
+	std::ostringstream out;
+	out << "O" << orderedSearch << " u" << undirectedGraph << " b" << certificateCanonicity
+			<< " q" << sequenceSearch << " r" << rootedTreeSearch
+			<< " g" << maximumGap << " D" << maxDepth << " R" << useOnlyThisRoot << " s";
+	if (relativeSupport > 0) {
+		out << relativeSupport;
+	} else {
+		out << absoluteSupport;
+	}
+	out << " N";
+	copy(useOnlyTheseLabels.begin(), useOnlyTheseLabels.end(), ostream_iterator<int>(out, ":"));
+	out << " E";
+	copy(excludeTheselabels.begin(), excludeTheselabels.end(), ostream_iterator<int>(out, ":"));
+	return (out.str());
+}
+
 /**
  * Prints usage on the standard output.
  */
 void usage() {
 	cout << "usage: "
-			<< "aadage [-[cdefmOoqruvy]] [-p <patternFile>] [-N <requiredLabels>] [-E <excludedLabels>] [-R <rootLabel>] [-s <minSupport>] [-x <maxSupport>] [-D <maxDepth>] [-g <maxGap>]  -i <inputFile>"
+			<< "aadage [-[bcdefmMOoqruvy]] [-p <patternFile>] [-N <requiredLabels>] [-E <excludedLabels>] [-R <rootLabel>] [-s <minSupport>] [-x <maxSupport>] [-D <maxDepth>] [-g <maxGap>] [-t <nbThreads>] [-k <nbPatterns>] [-I <stateFile>] [-A <appendedFile>] [-w <windowSize> [-S <step>]]  -i <inputFile>"
 			<< endl;
+	cout << "       -b       Test the canonical form of patterns with cycles" << endl;
+	cout << "                    using bliss certificates." << endl;
 	cout << "       -c       Display only closed patterns." << endl;
 	cout << "                    The closure concerns the calculation of"
 			<< endl;
@@ -2045,6 +2684,8 @@ void usage() {
 			<< endl;
 	cout << "       -m       count all occurences of a pattern in a graph." << endl;
 	cout << "                    If this option is not specified, a transactional setting is assumed." << endl;
+	cout << "       -M       Same as -m, but the occurences of a pattern are only counted" << endl;
+	cout << "                    until the min support is reached (the output counts are lower bounds)." << endl;
 //	cout << "       -O       ordered search (unordered search by default)"
 //			<< endl;
 	cout << "       -o       Print frequent patterns to standard output." << endl;
@@ -2071,6 +2712,31 @@ void usage() {
 	cout
 			<< "       -g       Specifies the maximum allowed gap (default is 0)."
 			<< endl;
+	cout
+			<< "       -t       Specifies the number of threads (default is 1)."
+			<< endl;
+	cout << "                    The order of the output patterns is not deterministic"
+			<< endl;
+	cout << "                    with several threads. Closed searches use one thread." << endl;
+	cout
+			<< "       -k       Output only the k patterns with the highest support."
+			<< endl;
+	cout << "                    The min support is raised as better patterns are found." << endl;
+	cout
+			<< "       -I       Specifies a state file storing the frequent patterns of the search."
+			<< endl;
+	cout << "                    With -A, only the appended trees are searched when possible." << endl;
+	cout
+			<< "       -A       Specifies a file of trees appended to the input file."
+			<< endl;
+	cout
+			<< "       -w       Searches the last <windowSize> graphs read on the standard input."
+			<< endl;
+	cout << "                    The changes of the frequent patterns are written: '+ ' before" << endl;
+	cout << "                    the new frequent patterns, '- ' before the other ones." << endl;
+	cout
+			<< "       -S       Specifies the number of graphs read between two changes (default is 1)."
+			<< endl;
 
 
 	cout		<< "       -i       Specifies the name of the input file (mandatory)."
@@ -2085,8 +2751,11 @@ bool parseParameters(int argc, char **argv) {
 	int index;
 	int c;
 	bool parametersOK = true;
-	while ((c = getopt(argc, argv, "cdefmOoqruvyp:N:E:R:s:x:D:g:i:")) != -1) {
+	while ((c = getopt(argc, argv, "bcdefmMOoqruvyp:N:E:R:s:x:D:g:t:k:I:A:w:S:i:")) != -1) {
 		switch (c) {
+		case 'b':
+			certificateCanonicity = true;
+			break;
 		case 'c':
 			closedSearch = true;
 			break;
@@ -2102,6 +2771,10 @@ bool parseParameters(int argc, char **argv) {
 		case 'm':
 			countUnique = false;
 			break;
+		case 'M':
+			countUnique = false;
+			stopCountAtSupport = true;
+			break;
 		case 'O':
 			orderedSearch = true;
 			break;
@@ -2184,6 +2857,32 @@ bool parseParameters(int argc, char **argv) {
 			iss >> maximumGap;
 		}
 			break;
+		case 't': {
+			std::istringstream iss(optarg);
+			iss >> nbThreads;
+		}
+			break;
+		case 'k': {
+			std::istringstream iss(optarg);
+			iss >> topK;
+		}
+			break;
+		case 'I':
+			stateFile = optarg;
+			break;
+		case 'A':
+			appendedFile = optarg;
+			break;
+		case 'w': {
+			std::istringstream iss(optarg);
+			iss >> windowSize;
+		}
+			break;
+		case 'S': {
+			std::istringstream iss(optarg);
+			iss >> streamStep;
+		}
+			break;
 		case 'i':
 			inputFile = optarg;
 			break;
@@ -2201,6 +2900,71 @@ bool parseParameters(int argc, char **argv) {
 		closedSequenceSearch = true;
 	}
 
+	if (nbThreads < 1) {
+		nbThreads = 1;
+	}
+	if ((nbThreads > 1) && (closedItemsetSearch || closedSequenceSearch)) {
+		// the closure of a candidate depends on previously processed candidates
+		nbThreads = 1;
+		cerr << "number of threads sets to 1 when searching closed patterns" << endl;
+	}
+
+	if (stopCountAtSupport && (closedItemsetSearch || closedSequenceSearch)) {
+		// the closure of a pattern is decided by comparing exact counts
+		stopCountAtSupport = false;
+		cerr << "stopCountAtSupport sets to false when searching closed patterns" << endl;
+	}
+
+	if (topK > 0) {
+		if (stopCountAtSupport) {
+			// the patterns are ranked on exact counts
+			stopCountAtSupport = false;
+			cerr << "stopCountAtSupport sets to false when searching the top-k patterns" << endl;
+		}
+		if (patternSearch) {
+			topK = 0;
+			cerr << "topK sets to 0 when using a pattern file" << endl;
+		}
+	}
+
+	if (windowSize > 0) {
+		if (!stateFile.empty() || !appendedFile.empty()) {
+			// the state of the window is kept in memory
+			stateFile.clear();
+			appendedFile.clear();
+			cerr << "stateFile sets to '' in streaming mode" << endl;
+		}
+		if (closedItemsetSearch || closedSequenceSearch || !countUnique || patternSearch
+				|| (topK > 0) || denseDataset || (absoluteMaxSupport != INT_MAX)
+				|| (relativeMaxSupport > 0)) {
+			// only the supports of the frequent patterns can be updated
+			windowSize = 0;
+			cerr << "windowSize sets to 0 with options -c, -d, -e, -m, -M, -p, -k, -x and -y" << endl;
+		} else if (nbThreads > 1) {
+			// the patterns are recorded in the order they are written
+			nbThreads = 1;
+			cerr << "number of threads sets to 1 in streaming mode" << endl;
+		}
+		if ((streamStep < 1) || (streamStep > windowSize)) {
+			streamStep = max(1, min(streamStep, windowSize));
+			cerr << "streamStep sets to " << streamStep << endl;
+		}
+	}
+
+	if (!stateFile.empty()) {
+		if (closedItemsetSearch || closedSequenceSearch || !countUnique || patternSearch
+				|| (topK > 0) || denseDataset || (absoluteMaxSupport != INT_MAX)
+				|| (relativeMaxSupport > 0)) {
+			// only the supports of the frequent patterns can be updated
+			stateFile.clear();
+			cerr << "stateFile sets to '' with options -c, -d, -e, -m, -M, -p, -k, -x and -y" << endl;
+		} else if (nbThreads > 1) {
+			// the patterns are recorded in the order they are written
+			nbThreads = 1;
+			cerr << "number of threads sets to 1 when using a state file" << endl;
+		}
+	}
+
 	if (patternSearch > 0) {
 		if (absoluteSupport != 0) {
 			absoluteSupport = 0;
@@ -2217,7 +2981,7 @@ bool parseParameters(int argc, char **argv) {
 			cout << "ordered=" << orderedSearch << ", unique count="
 					<< countUnique << ", out=" << outputFrequentTrees
 					<< ", infile=" << inputFile << ", support="
-					<< (relativeSupport > 0 ? relativeSupport : absoluteSupport)
+					<< (relativeSupport > 0 ? relativeSupport : absoluteSupport.load())
 					<< ", max support="
 					<< (relativeMaxSupport > 0 ? relativeMaxSupport : absoluteMaxSupport)
 					<< endl;
@@ -2240,6 +3004,353 @@ double memUsed(){
     return (rss);
 }
 
+/**
+ * Searches the trees appended to the dataset of the state.
+ * The appended trees are searched alone, and only the patterns that were
+ * frequent in the previous searches are extended. The support of a pattern
+ * is the sum of its recorded support and of its support in the appended
+ * trees. When a pattern that was not frequent may become frequent, the
+ * whole dataset must be searched and the state is not changed.
+ * @param appendedNodes the appended trees
+ * @param support the min support, for the dataset with the appended trees
+ * @return true if the state is updated, false if the whole dataset must be
+ * searched
+ */
+bool searchAppendedTrees(const Dataset& appendedNodes, const int support) {
+	Dataset newNodes(appendedNodes);
+	appendedState.clear();
+	appendedState.nbTrees = newNodes.size();
+	countLabelTrees(newNodes, appendedState.labelTrees);
+	int rootLabel = useOnlyThisRoot;
+	datasetSize = newNodes.size();
+	absoluteSupport = 1;
+	set<int> frequentNodes;
+	selectLabels(newNodes, frequentNodes);
+	// the labels that are not in the recorded patterns and cannot become
+	// frequent are not searched ; the patterns containing them are not
+	// recorded in the appended trees either
+	for (map<int, int>::const_iterator it = appendedState.labelTrees.begin();
+			it != appendedState.labelTrees.end(); it++) {
+		if (!incrementalState.isRecorded(it->first)
+				&& (incrementalState.labelTrees[it->first] + it->second < support)) {
+			frequentNodes.erase(it->first);
+			appendedState.unknownLabelTrees[it->first] = it->second;
+		}
+	}
+	removeUnfrequentNodes(newNodes, frequentNodes);
+	remapInputLabels(newNodes);
+
+	countAppendedTrees = true;
+	Candidates candidates;
+	initializeCandidates(candidates, newNodes);
+	while (!candidates.currentCandidates.empty()) {
+		performJoin(candidates, newNodes);
+	}
+	countAppendedTrees = false;
+	useOnlyThisRoot = rootLabel;
+	absoluteSupport = support;
+
+	if (incrementalState.canBecomeFrequent(appendedState, support)) {
+		if (verbose) {
+			cout << "new frequent patterns in the appended trees, the whole dataset is searched" << endl;
+		}
+		return (false);
+	}
+	incrementalState.append(appendedState);
+	return (true);
+}
+
+/**
+ * Returns the frequent patterns of the state, in the order they were found.
+ * @param support the min support
+ * @param frequents the text and the support of the frequent patterns
+ */
+void getFrequentPatterns(const int support, vector<pair<string, int> >& frequents) {
+	vector<pair<const string*, const IncrementalState::Entry*> > ranked;
+	incrementalState.getExtended(ranked);
+	for (int i = 0; i < (int) ranked.size(); i++) {
+		int count = ranked[i].second->trees.count(incrementalState.firstTree);
+		if (count >= support) {
+			frequents.push_back(pair<string, int>(*ranked[i].first, count));
+		}
+	}
+}
+
+/**
+ * Searches the trees appended to the dataset of the state file, and writes
+ * the frequent patterns.
+ * @param appendedNodes the appended trees
+ * @param signature the options of the search
+ * @return true if the frequent patterns are found, false if the whole
+ * dataset must be searched
+ */
+bool mineAppendedTrees(const Dataset& appendedNodes, const string& signature) {
+	if (!incrementalState.read(stateFile) || (incrementalState.signature != signature)) {
+		if (verbose) {
+			cout << "no previous search with the same options in '" << stateFile << "'" << endl;
+		}
+		return (false);
+	}
+	int nbTrees = incrementalState.nbTrees + appendedNodes.size();
+	int support = absoluteSupport;
+	if (relativeSupport > 0) {
+		support = nbTrees * relativeSupport;
+	}
+	if (!searchAppendedTrees(appendedNodes, support)) {
+		return (false);
+	}
+	datasetSize = nbTrees;
+	if (verbose) {
+		cout << "size of dataset : " << datasetSize << endl;
+	}
+	if (outputFrequentTrees) {
+		vector<pair<string, int> > frequents;
+		getFrequentPatterns(support, frequents);
+		for (int i = 0; i < (int) frequents.size(); i++) {
+			writeSolution(frequents[i].first, frequents[i].second);
+		}
+	}
+	return (true);
+}
+
+/**
+ * Starts the recording of the patterns of a search in the state.
+ * @param inputNodes the dataset, before its labels are selected
+ * @param firstTree the index of the first tree of the dataset in the state
+ */
+void startRecording(const Dataset& inputNodes, const int firstTree) {
+	recordPatterns = true;
+	incrementalState.clear();
+	incrementalState.firstTree = firstTree;
+	incrementalState.nbTrees = firstTree + inputNodes.size();
+	countLabelTrees(inputNodes, incrementalState.labelTrees);
+}
+
+/**
+ * Searches the patterns of a dataset whose labels are selected.
+ * @param inputNodes the dataset
+ */
+void searchPatterns(Dataset& inputNodes) {
+	int rootLabel = useOnlyThisRoot;
+	remapInputLabels(inputNodes);
+
+	// creates first list of candidates. One for each node
+	Candidates candidates;
+	initializeCandidates(candidates, inputNodes);
+
+	bool theEnd = candidates.currentCandidates.empty();
+	if (nbThreads > 1) {
+		mineInParallel(candidates, inputNodes);
+		theEnd = true;
+	}
+	while (!theEnd) {
+		if (verbose){
+			cout << "nb candidates : " << candidates.candidates.size() << "(memUsed=" << memUsed() << ")" << endl;
+		}
+		performJoin(candidates, inputNodes);
+		theEnd = candidates.currentCandidates.empty();
+	}
+	if (closedSequenceSearch) {
+		// closed patterns are written in the order of their label paths
+		map<vector<pair<ItemSet, int> >, int> closedPatterns;
+		for (unordered_map<int, CandidateInfo >::const_iterator it =
+				candidates.candidates.begin(); it != candidates.candidates.end();
+				it++) {
+			if (!it->second.isClosed
+					&& (it->second.perTreeFrequency >= absoluteSupport)) {
+				vector<pair<ItemSet, int> > label;
+				candidates.getLabel(it->first, label);
+				closedPatterns[label] = it->second.perTreeFrequency;
+			}
+		}
+		for (map<vector<pair<ItemSet, int> >, int>::const_iterator it =
+				closedPatterns.begin(); it != closedPatterns.end(); it++) {
+			writeSolution(candidates, it->first, it->second);
+		}
+	}
+	useOnlyThisRoot = rootLabel;
+}
+
+/**
+ * the graph being read on the standard input in the Imit format, whose end
+ * is only known when the next graph starts.
+ */
+vector<NodeInfo> streamNodes;
+map<int, int> streamNodeIds;
+bool streamGraphStarted = false;
+
+/**
+ * Reads graphs on a stream, in the Sleuth/treeMiner or the Imit format.
+ * @param in the stream
+ * @param format the format of the stream, detected on its first line if -1
+ * @param nbGraphs the maximum number of graphs to read
+ * @param graphs the graphs read, one dataset per graph
+ * @return the number of graphs read ; -1 if the format is not supported
+ */
+int readStreamGraphs(istream& in, int& format, const int nbGraphs, deque<Dataset>& graphs) {
+	int nbRead = 0;
+	string line;
+	while ((nbRead < nbGraphs) && getline(in, line)) {
+		if (line.empty() || (line[0] == '#')) {
+			continue;
+		}
+		if (format == -1) {
+			format = getLineFormat(line);
+			if ((format != 1) && (format != 3)) {
+				return (-1);
+			}
+		}
+		vector<NodeInfo> nodes;
+		if (format == 1) {
+			if (!parseTreeLine(line, nodes)) {
+				continue;
+			}
+		} else if ((line[0] == 'g') || (line[0] == 't') || (line[0] == 'X')) {
+			bool started = streamGraphStarted;
+			streamGraphStarted = true;
+			if (!started) {
+				continue;
+			}
+			nodes.swap(streamNodes);
+			streamNodeIds.clear();
+		} else {
+			parseGraphLine(line, streamNodes, streamNodeIds);
+			continue;
+		}
+		graphs.push_back(Dataset());
+		graphs.back().addGraph(nodes);
+		nbRead++;
+	}
+	if ((nbRead < nbGraphs) && streamGraphStarted) {
+		// the last graph ends with the stream
+		graphs.push_back(Dataset());
+		graphs.back().addGraph(streamNodes);
+		nbRead++;
+		streamNodes.clear();
+		streamNodeIds.clear();
+		streamGraphStarted = false;
+	}
+	return (nbRead);
+}
+
+/**
+ * Writes the changes of the frequent patterns in streaming mode: the
+ * patterns that become frequent are written with their support after "+ ",
+ * the patterns that are no longer frequent after "- ".
+ * @param previous the patterns that were frequent
+ * @param current the patterns that are frequent
+ * @param nbGraphs the number of graphs read
+ */
+void writeChanges(const vector<pair<string, int> >& previous,
+		const vector<pair<string, int> >& current, const int nbGraphs) {
+	unordered_set<string> previousPatterns;
+	unordered_set<string> currentPatterns;
+	for (int i = 0; i < (int) previous.size(); i++) {
+		previousPatterns.insert(previous[i].first);
+	}
+	for (int i = 0; i < (int) current.size(); i++) {
+		currentPatterns.insert(current[i].first);
+	}
+	bool changed = false;
+	for (int i = 0; i < (int) previous.size(); i++) {
+		if (currentPatterns.count(previous[i].first) == 0) {
+			if (!changed) {
+				std::ostringstream out;
+				out << "# " << nbGraphs << endl;
+				writeOutput(out.str());
+				changed = true;
+			}
+			writeOutput("- " + previous[i].first + "\n");
+		}
+	}
+	for (int i = 0; i < (int) current.size(); i++) {
+		if (previousPatterns.count(current[i].first) == 0) {
+			if (!changed) {
+				std::ostringstream out;
+				out << "# " << nbGraphs << endl;
+				writeOutput(out.str());
+				changed = true;
+			}
+			writeSolution("+ " + current[i].first, current[i].second);
+		}
+	}
+}
+
+/**
+ * Searches the frequent patterns of the last windowSize graphs read on the
+ * standard input. Every streamStep graphs, the supports of the frequent
+ * patterns and of their extensions are updated with the graphs entering
+ * and leaving the window, and the changes of the frequent patterns are
+ * written. The whole window is only searched when a pattern that was not
+ * frequent may become frequent.
+ * @return 0 if the processing is OK ; -1 if the process fails
+ */
+int mineStream() {
+	bool output = outputFrequentTrees;
+	outputFrequentTrees = false;
+	if (relativeSupport > 0) {
+		// the support is relative to the size of a full window
+		absoluteSupport = windowSize * relativeSupport;
+		relativeSupport = 0;
+	}
+	int fixedSupport = absoluteSupport;
+	deque<Dataset> window;
+	vector<pair<string, int> > frequents;
+	int format = -1;
+	int nbGraphs = 0;
+	while (true) {
+		deque<Dataset> graphs;
+		int nbRead = readStreamGraphs(cin, format, streamStep, graphs);
+		if (nbRead == -1) {
+			cout << "the format of the standard input is not supported in streaming mode" << endl;
+			return (-1);
+		}
+		if (nbRead == 0) {
+			break;
+		}
+		// the first graphs leave the window
+		int nbRemoved = max(0, (int) (window.size() + graphs.size()) - windowSize);
+		map<int, int> removedLabels;
+		for (int i = 0; i < nbRemoved; i++) {
+			countLabelTrees(window.front(), removedLabels);
+			window.pop_front();
+		}
+		incrementalState.removeTrees(nbRemoved, removedLabels);
+		Dataset appendedNodes;
+		for (deque<Dataset>::const_iterator it = graphs.begin(); it != graphs.end(); it++) {
+			appendedNodes.addGraphs(*it);
+		}
+		window.insert(window.end(), graphs.begin(), graphs.end());
+
+		bool updated = (nbGraphs > 0) && searchAppendedTrees(appendedNodes, fixedSupport);
+		nbGraphs += nbRead;
+		if (!updated) {
+			Dataset inputNodes;
+			for (deque<Dataset>::const_iterator it = window.begin(); it != window.end(); it++) {
+				inputNodes.addGraphs(*it);
+			}
+			startRecording(inputNodes, nbGraphs - window.size());
+			absoluteSupport = fixedSupport;
+			prepareInputNodes(inputNodes);
+			searchPatterns(inputNodes);
+		}
+		if (nbGraphs % windowSize < nbRead) {
+			// about once per window
+			incrementalState.forgetRemovedTrees();
+		}
+
+		datasetSize = window.size();
+		vector<pair<string, int> > current;
+		getFrequentPatterns(fixedSupport, current);
+		if (output) {
+			writeChanges(frequents, current, nbGraphs);
+		}
+		frequents.swap(current);
+	}
+	outputFrequentTrees = output;
+	return (0);
+}
+
 /**
  * main function.
  */
@@ -2250,11 +3361,36 @@ int main(int argc, char **argv) {
 	/*
 	 * Read input file and initialize inputNodes
 	 */
-	vector<vector<NodeInfo> > inputNodes;
-	if (initializeInputNodes(inputFile, inputNodes) == -1) {
+	if (windowSize > 0) {
+		return (mineStream());
+	}
+	string signature = getSearchSignature();
+	Dataset appendedNodes;
+	if (!appendedFile.empty() && (loadInputNodes(appendedFile, appendedNodes) == -1)) {
+		cout << "problem reading appended dataset  '" << appendedFile << "'" << endl;
+		return (-1);
+	}
+	if (!stateFile.empty() && !appendedFile.empty()
+			&& mineAppendedTrees(appendedNodes, signature)) {
+		if (!incrementalState.write(stateFile)) {
+			cout << "problem writing state file '" << stateFile << "'" << endl;
+			return (-1);
+		}
+		return (0);
+	}
+
+	Dataset inputNodes;
+	if (loadInputNodes(inputFile, inputNodes) == -1) {
 		cout << "problem reading input dataset  '" << inputFile << "'" << endl;
 		return (-1);
 	}
+	inputNodes.addGraphs(appendedNodes);
+	if (!stateFile.empty()) {
+		// the patterns of the search are recorded for the next appended trees
+		startRecording(inputNodes, 0);
+		incrementalState.signature = signature;
+	}
+	prepareInputNodes(inputNodes);
 
 
 
@@ -2263,7 +3399,7 @@ int main(int argc, char **argv) {
 	 * If a pattern file is specified
 	 * Read pattern file and initialize patternNodes and patternOccurences
 	 */
-	vector<vector<NodeInfo> > patternNodes;
+	Dataset patternNodes;
 	if (patternSearch) {
 		if (initializePatternNodes(patternFile, patternNodes,
 				patternFrequencies) == -1) {
@@ -2276,33 +3412,21 @@ int main(int argc, char **argv) {
 
 	if (patternSearch) {
 		// add patternNodes at the beginning of inputNodes
-		inputNodes.insert(inputNodes.begin(), patternNodes.begin(),
-				patternNodes.end());
+		patternNodes.addGraphs(inputNodes);
+		inputNodes.swap(patternNodes);
 		// Now, the entire dataset is separated in two part
 		// part one, the patterns (treeId < patternsCount)
 		// part two, the attributed trees to mine (treeId >= patternsCount)
 	}
 
-	// creates first list of candidates. One for each node
-	Candidates candidates;
-	initializeCandidates(candidates, inputNodes);
-
-	bool theEnd = candidates.currentCandidates.empty();
-	while (!theEnd) {
-		if (verbose){
-			cout << "nb candidates : " << candidates.candidates.size() << "(memUsed=" << memUsed() << ")" << endl;
-		}
-		performJoin(candidates, inputNodes);
-		theEnd = candidates.currentCandidates.empty();
+	searchPatterns(inputNodes);
+	if (topK > 0) {
+		writeTopSolutions();
 	}
-	if (closedSequenceSearch) {
-		for (map<vector<pair<set<int>, int> >, CandidateInfo >::const_iterator it =
-				candidates.candidates.begin(); it != candidates.candidates.end();
-				it++) {
-			if (!it->second.isClosed
-					&& (it->second.perTreeFrequency >= absoluteSupport)) {
-				writeSolution(candidates, it->first, it->second.perTreeFrequency);
-			}
+	if (recordPatterns) {
+		if (!incrementalState.write(stateFile)) {
+			cout << "problem writing state file '" << stateFile << "'" << endl;
+			return (-1);
 		}
 	}
 	return (0);
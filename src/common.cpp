@@ -63,3 +63,10 @@ void join(const vector<int>& tokens, string& result, const string& delimiter =
 	result = oss.str();
 }
 
+size_t IntSequenceHash::operator()(const vector<int>& sequence) const {
+	size_t h = sequence.size();
+	for (vector<int>::const_iterator it = sequence.begin(); it != sequence.end(); it++) {
+		h ^= (size_t) *it + 0x9E3779B9 + (h << 6) + (h >> 2);
+	}
+	return (h);
+}
@@ -30,4 +30,12 @@ void split(const string&, deque<string>&, const string& delimiters = " ",
 void join(vector<string>&, string&, const string&);
 void join(const vector<int>&, string&, const string&);
 
+/**
+ * A hash function for sequences of integers, to use them as keys of
+ * unordered containers.
+ */
+struct IntSequenceHash {
+	size_t operator()(const vector<int>& sequence) const;
+};
+
 #endif /* COMMON_H_ */